@@ -1,6 +1,8 @@
 // SPDX-FileCopyrightText: 2025 Gridshadows <https://www.gridshadows.co.uk>
 // SPDX-License-Identifier: Zlib
 
+#include "statistics.hpp"
+
 #include "clang/AST/ASTContext.h"
 #include "clang/AST/Attr.h"
 #include "clang/Sema/ParsedAttr.h"
@@ -63,6 +65,7 @@ template<std::size_t N> constexpr int64_t ConstStrLen(const char (&Str)[N]) { re
             \
             AttrHandling handleDeclAttribute(Sema& s, Decl* d, const ParsedAttr& attr) const override \
             { \
+                PhaseScope scope(Phase::Attributes, "godot::" #NAME); \
                 if(!d->getDeclContext()->isRecord()) \
                 { \
                     unsigned id = s.getDiagnostics().getCustomDiagID(DiagnosticsEngine::Error, \
@@ -135,14 +138,6 @@ template<std::size_t N> constexpr int64_t ConstStrLen(const char (&Str)[N]) { re
     }\
     static ParsedAttrInfoRegistry::Add<NAME##AttrInfo> Godot##NAME("godot_" #NAME, "")
 
-/**
- * Defines, and registers, the class for managing a custom attribute for a C++ functions
- * which takes no arguments
- *
- * @param NAME The name of the attribute, within the godot namespace
- */
-#define DefineFunctionAttrInfoNoArgs(NAME) DefineFunctionAttrInfo(NAME, 0, 0, "")
-
 /**
  * Defines, and registers, the class for managing a custom attribute for a C++ type definitions
  * (class, enum, etc)
@@ -178,6 +173,7 @@ template<std::size_t N> constexpr int64_t ConstStrLen(const char (&Str)[N]) { re
             \
             AttrHandling handleDeclAttribute(Sema& s, Decl* d, const ParsedAttr& attr) const override \
             { \
+                PhaseScope scope(Phase::Attributes, "godot::" #NAME); \
                 if constexpr(MUST_BE_SUB) \
                 { \
                     if(!d->getDeclContext()->isRecord()) \
@@ -211,58 +207,8 @@ template<std::size_t N> constexpr int64_t ConstStrLen(const char (&Str)[N]) { re
     static ParsedAttrInfoRegistry::Add<NAME##AttrInfo> Godot##NAME("godot_" #NAME, "")
 
 /**
- * Defines the godot::method attribute for defining methods of a Godot class to export
- */
-DefineFunctionAttrInfoNoArgs(method);
-
-/**
- * Defines the godot::signal attribute for defining signals from a Godot class to export
- */
-DefineFunctionAttrInfoNoArgs(signal);
-
-/**
- * Defines the godot::getter attribute for defining the getter for a Godot class member to export
- */
-DefineFunctionAttrInfo(getter, 0, 3, "get");
-
-/**
- * Defines the godot::setter attribute for defining the setter for a Godot class member to export
- */
-DefineFunctionAttrInfo(setter, 0, 3, "set");
-
-/**
- * Defines the godot::group attribute for defining the a group for Godot members
+ * Defines, and registers, the classes for each attribute listed in attributes.def
  */
-DefineFunctionAttrInfo(group, 1, 1, "");
-
-/**
- * Defines the godot::group attribute for defining the a subgroup for Godot members
- */
-DefineFunctionAttrInfo(subgroup, 1, 1, "");
-
-/**
- * Defines the godot::tool attribute for defining a Godot class for use as a "tool"
- */
-DefineTypeAttrInfo(tool, CXXRecordDecl, false);
-
-/**
- * Defines the godot::class attribute for defining a Godot class
- */
-DefineTypeAttrInfo(class, CXXRecordDecl, false);
-
-/**
- * Defines the godot::enum attribute for defining a Godot enumeration
- */
-DefineTypeAttrInfo(enum, EnumDecl, true);
-
-/**
- * Defines the godot::enum attribute for defining a Godot bitfield
- */
-DefineTypeAttrInfo(bitfield, EnumDecl, true);
-
-/**
- * Defines the godot::enum attribute for defining a set of Godot constants
- */
-DefineTypeAttrInfo(constants, EnumDecl, true);
-
-// TODO: Add support for groups, subgroups
+#define GODOT_FUNCTION_ATTRIBUTE(NAME, ENUM, REQ, OPT, NAME_PREFIX) DefineFunctionAttrInfo(NAME, REQ, OPT, NAME_PREFIX);
+#define GODOT_TYPE_ATTRIBUTE(NAME, ENUM, TYPE, MUST_BE_SUB) DefineTypeAttrInfo(NAME, TYPE, MUST_BE_SUB);
+#include "attributes.def"
@@ -0,0 +1,531 @@
+// SPDX-FileCopyrightText: 2025 Gridshadows Gaming <https://www.gridshadows.co.uk>
+// SPDX-License-Identifier: Zlib
+
+#include "gdexport.hpp"
+
+#include "clang/Basic/FileManager.h"
+#include "clang/Tooling/ArgumentsAdjusters.h"
+#include "clang/Tooling/CompilationDatabase.h"
+#include "clang/Tooling/JSONCompilationDatabase.h"
+#include "clang/Tooling/Tooling.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/Threading.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <mutex>
+
+using namespace clang;
+
+/**
+ * A header file to process, read from the list of headers passed to the batch driver
+ */
+struct BatchHeader
+{
+    /**
+     * The header file to process
+     */
+    std::string Header;
+
+    /**
+     * The file to write the generated code to
+     */
+    std::string Output;
+
+    /**
+     * The dependency file to write (or empty to not write a dependency file)
+     */
+    std::optional<std::string> Dependencies;
+
+    /**
+     * The manifest file to write (or empty to not write a manifest)
+     */
+    std::optional<std::string> Manifest;
+
+    /**
+     * The statistics file to write (or empty to not record statistics)
+     */
+    std::optional<std::string> Statistics;
+
+    /**
+     * The dump of the exported interface to write (or empty to not write a dump)
+     */
+    std::optional<std::string> Interface;
+
+    /**
+     * Specifies whether to register the properties and signals from constant tables
+     */
+    bool Tables;
+
+    /**
+     * Specifies whether to bind the methods with generated call and ptrcall functions
+     */
+    bool Thunks;
+};
+
+/**
+ * Parse the list of headers to process. Each non-empty line of the list contains the header, the
+ * generated file, and optionally the dependency file, manifest file, statistics file and
+ * interface dump, separated with tabs.
+ *
+ * @param list The content of the list
+ * @param tables Specifies whether to use tables for every header (see BatchHeader::Tables)
+ * @param thunks Specifies whether to use thunks for every header (see BatchHeader::Thunks)
+ * @param headers The list to append the headers to
+ * @return true on success; false if a line is invalid
+ */
+static bool ParseHeaderList(StringRef list, bool tables, bool thunks, std::vector<BatchHeader>& headers)
+{
+    SmallVector<StringRef, 0> lines;
+    list.split(lines, '\n', -1, false);
+    for(StringRef line : lines)
+    {
+        line = line.rtrim("\r");
+        if(line.trim().empty())
+        {
+            continue;
+        }
+        SmallVector<StringRef, 6> fields;
+        line.split(fields, '\t');
+        if((fields.size() < 2) || (fields.size() > 6) || fields[0].empty() || fields[1].empty())
+        {
+            llvm::errs() << "gdexport-batch: invalid line in header list: '" << line << "'\n";
+            return false;
+        }
+        BatchHeader header{fields[0].str(), fields[1].str(), std::nullopt, std::nullopt, std::nullopt, std::nullopt,
+            tables, thunks};
+        if((fields.size() >= 3) && !fields[2].empty())
+        {
+            header.Dependencies = fields[2].str();
+        }
+        if((fields.size() >= 4) && !fields[3].empty())
+        {
+            header.Manifest = fields[3].str();
+        }
+        if((fields.size() >= 5) && !fields[4].empty())
+        {
+            header.Statistics = fields[4].str();
+        }
+        if((fields.size() == 6) && !fields[5].empty())
+        {
+            header.Interface = fields[5].str();
+        }
+        headers.push_back(std::move(header));
+    }
+    return true;
+}
+
+/**
+ * Process a header file, running GenerateExtensionInterface as the main frontend action.
+ *
+ * Prints ":file <header>" to the stream before processing the header, followed by the names of
+ * the classes for which documentation is generated.
+ *
+ * @param arguments The clang command line (including the header file)
+ * @param header The header to process
+ * @param doc The output directory to write XML documentation to (or empty to not write documentation)
+ * @param docJobs The number of threads to write the XML documentation files with (or 0 to write
+ *                each file while traversing the AST)
+ * @param docBudget The number of bytes of XML documentation to hold in memory (or empty to not
+ *                  stream the documentation)
+ * @param files The file manager to use for the header
+ * @param pchOperations The PCH container operations to use for the header
+ * @param os The stream to print the header and class names to
+ * @return true on success; false if an error occurred
+ */
+static bool ProcessHeader(std::vector<std::string> arguments, const BatchHeader& header,
+    const std::optional<std::string>& doc, unsigned int docJobs, std::optional<std::size_t> docBudget,
+    FileManager* files,
+    std::shared_ptr<PCHContainerOperations> pchOperations, llvm::raw_ostream& os)
+{
+    os << ":file " << header.Header << "\n";
+    auto action = std::make_unique<GenerateExtensionInterface>(header.Output, doc, header.Dependencies,
+        header.Manifest, header.Tables, header.Thunks, docJobs, header.Statistics, docBudget,
+        header.Interface);
+    action->SetClassNamesStream(os);
+    tooling::ToolInvocation invocation(std::move(arguments), std::move(action), files, std::move(pchOperations));
+    bool result = invocation.run();
+    os.flush();
+    return result;
+}
+
+/**
+ * Process a header file with the clang command line given
+ *
+ * @param command The clang command line (without the header file)
+ * @param header The header to process
+ * @param doc The output directory to write XML documentation to (or empty to not write documentation)
+ * @param docJobs The number of threads to write the XML documentation files with
+ * @param docBudget The number of bytes of XML documentation to hold in memory (or empty to not
+ *                  stream the documentation)
+ * @param files The file manager to use for the header
+ * @param pchOperations The PCH container operations to use for the header
+ * @return true on success; false if an error occurred
+ */
+static bool ProcessHeader(const std::vector<std::string>& command, const BatchHeader& header,
+    const std::optional<std::string>& doc, unsigned int docJobs, std::optional<std::size_t> docBudget,
+    FileManager* files,
+    std::shared_ptr<PCHContainerOperations> pchOperations)
+{
+    std::vector<std::string> arguments(command);
+    arguments.push_back(header.Header);
+    return ProcessHeader(std::move(arguments), header, doc, docJobs, docBudget, files, std::move(pchOperations),
+        llvm::outs());
+}
+
+/**
+ * Load a compilation database (compile_commands.json), inferring the commands for header files,
+ * which are not listed in the database, from the command for the source file most likely to
+ * include each header (see tooling::inferMissingCompileCommands)
+ *
+ * @param path The compilation database, or the build directory containing compile_commands.json
+ * @return The compilation database, or null (after printing the error) if it could not be loaded
+ */
+static std::unique_ptr<tooling::CompilationDatabase> LoadCompilationDatabase(StringRef path)
+{
+    std::string error;
+    std::unique_ptr<tooling::CompilationDatabase> database;
+    if(llvm::sys::fs::is_directory(path))
+    {
+        database = tooling::CompilationDatabase::loadFromDirectory(path, error);
+    }
+    else
+    {
+        database = tooling::JSONCompilationDatabase::loadFromFile(path, error,
+            tooling::JSONCommandLineSyntax::AutoDetect);
+    }
+    if(!database)
+    {
+        llvm::errs() << "gdexport-batch: unable to load compilation database '" << path << "': " << error << "\n";
+        return nullptr;
+    }
+    return tooling::inferMissingCompileCommands(std::move(database));
+}
+
+/**
+ * Process the headers with the commands from a compilation database, on a thread pool. Each
+ * header is parsed with the exact flags of the build (in the working directory of the command),
+ * adjusted to only check the syntax (without writing any output or dependency files).
+ *
+ * The header and class names for each header are printed to stdout once the header is processed
+ * (so the order is not the order of the headers).
+ *
+ * @param database The compilation database
+ * @param headers The headers to process
+ * @param extra Extra clang arguments to add to each command
+ * @param doc The output directory to write XML documentation to (or empty to not write documentation)
+ * @param docJobs The number of threads to write the XML documentation files for each header with
+ * @param docBudget The number of bytes of XML documentation to hold in memory (or empty to not
+ *                  stream the documentation)
+ * @param jobs The number of headers to process in parallel (or 0 for the number of CPUs)
+ * @return 0 if every header was processed successfully; 1 otherwise
+ */
+static int ProcessDatabase(const tooling::CompilationDatabase& database, const std::vector<BatchHeader>& headers,
+    const std::vector<std::string>& extra, const std::optional<std::string>& doc, unsigned int docJobs,
+    std::optional<std::size_t> docBudget, unsigned int jobs)
+{
+    auto adjuster = tooling::combineAdjusters(tooling::getClangStripOutputAdjuster(),
+        tooling::combineAdjusters(tooling::getClangStripDependencyFileAdjuster(),
+            tooling::combineAdjusters(tooling::getClangSyntaxOnlyAdjuster(),
+                tooling::getInsertArgumentAdjuster(extra, tooling::ArgumentInsertPosition::END))));
+    auto pchOperations = std::make_shared<PCHContainerOperations>();
+    std::mutex outputMutex;
+    std::atomic<int> result(0);
+    llvm::DefaultThreadPool pool(llvm::hardware_concurrency(jobs));
+    for(const auto& header : headers)
+    {
+        pool.async([&, header]() mutable
+            {
+                // Absolute, as the header is parsed in the working directory of its command
+                SmallString<256> path(header.Header);
+                llvm::sys::fs::make_absolute(path);
+                auto commands = database.getCompileCommands(path);
+                std::string names;
+                llvm::raw_string_ostream os(names);
+                bool success = false;
+                if(commands.empty())
+                {
+                    os << ":file " << header.Header << "\n";
+                    std::lock_guard<std::mutex> lock(outputMutex);
+                    llvm::errs() << "gdexport-batch: no compile command for '" << header.Header << "'\n";
+                }
+                else
+                {
+                    const auto& command = commands.front();
+                    // A file system (and so file manager) for each header, so each has its own
+                    // working directory, and the file managers are not shared between threads
+                    IntrusiveRefCntPtr<llvm::vfs::FileSystem> fs(llvm::vfs::createPhysicalFileSystem().release());
+                    fs->setCurrentWorkingDirectory(command.Directory);
+                    IntrusiveRefCntPtr<FileManager> files(new FileManager(FileSystemOptions(), fs));
+                    success = ProcessHeader(adjuster(command.CommandLine, command.Filename), header, doc, docJobs,
+                        docBudget, files.get(), pchOperations, os);
+                }
+                os.flush();
+                std::lock_guard<std::mutex> lock(outputMutex);
+                llvm::outs() << names;
+                llvm::outs().flush();
+                if(!success)
+                {
+                    result = 1;
+                }
+            });
+    }
+    pool.wait();
+    return result;
+}
+
+/**
+ * Parse a request to the server. Each request is a JSON object on a single line, containing the
+ * clang command line ("command"), the header file ("header"), the generated file ("output"), and
+ * optionally the documentation folder ("documentation"), dependency file ("dependencies"),
+ * manifest file ("manifest"), statistics file ("stats"), interface dump ("interface"), whether
+ * to use tables ("tables"), whether to use thunks ("thunks"), the number of threads to write the documentation with
+ * ("doc_jobs") and the number of bytes of documentation to hold in memory ("doc_budget")
+ *
+ * @param line The line containing the request
+ * @param command The clang command line for the request
+ * @param header The header to process for the request
+ * @param doc The documentation folder for the request
+ * @param docJobs The number of threads to write the documentation with for the request
+ * @param docBudget The number of bytes of documentation to hold in memory for the request
+ * @return true on success; false if the request is invalid
+ */
+static bool ParseRequest(StringRef line, std::vector<std::string>& command, BatchHeader& header,
+    std::optional<std::string>& doc, int& docJobs, std::optional<std::size_t>& docBudget)
+{
+    std::optional<int64_t> budget;
+    auto request = llvm::json::parse(line);
+    if(!request)
+    {
+        llvm::errs() << "gdexport-batch: invalid request: " << llvm::toString(request.takeError()) << "\n";
+        return false;
+    }
+    llvm::json::Path::Root root("request");
+    llvm::json::ObjectMapper mapper(*request, root);
+    if(!mapper || !mapper.map("command", command) || !mapper.map("header", header.Header)
+        || !mapper.map("output", header.Output) || !mapper.mapOptional("documentation", doc)
+        || !mapper.mapOptional("dependencies", header.Dependencies)
+        || !mapper.mapOptional("manifest", header.Manifest)
+        || !mapper.mapOptional("stats", header.Statistics)
+        || !mapper.mapOptional("interface", header.Interface)
+        || !mapper.mapOptional("tables", header.Tables)
+        || !mapper.mapOptional("thunks", header.Thunks)
+        || !mapper.mapOptional("doc_jobs", docJobs) || (docJobs < 0)
+        || !mapper.mapOptional("doc_budget", budget) || (budget && (*budget < 0))
+        || command.empty() || header.Header.empty() || header.Output.empty())
+    {
+        llvm::errs() << "gdexport-batch: invalid request: '" << line << "'\n";
+        return false;
+    }
+    if(budget)
+    {
+        docBudget = static_cast<std::size_t>(*budget);
+    }
+    return true;
+}
+
+/**
+ * Run the server, processing a request from each line of stdin until the end of stdin. After each
+ * request prints ":done 0" to stdout on success, or ":done 1" on error.
+ *
+ * A new FileManager is used for each request, as the files may have changed between requests.
+ *
+ * @return 0
+ */
+static int RunServer()
+{
+    auto pchOperations = std::make_shared<PCHContainerOperations>();
+    std::string line;
+    while(std::getline(std::cin, line))
+    {
+        if(StringRef(line).trim().empty())
+        {
+            continue;
+        }
+        std::vector<std::string> command;
+        BatchHeader header{};
+        std::optional<std::string> doc;
+        int docJobs = 0;
+        std::optional<std::size_t> docBudget;
+        bool result = ParseRequest(line, command, header, doc, docJobs, docBudget);
+        if(result)
+        {
+            IntrusiveRefCntPtr<FileManager> files(new FileManager(FileSystemOptions(), llvm::vfs::getRealFileSystem()));
+            result = ProcessHeader(command, header, doc, docJobs, docBudget, files.get(), pchOperations);
+        }
+        llvm::outs() << ":done " << (result ? 0 : 1) << "\n";
+        llvm::outs().flush();
+    }
+    return 0;
+}
+
+/**
+ * Print the usage of the batch driver
+ */
+static void PrintUsage()
+{
+    llvm::errs() << "usage: gdexport-batch [-doc <dir>] [-doc-jobs <n>] [-doc-budget <bytes>] [-tables] [-thunks] <header-list> -- <clang> [<clang-arguments>...]\n"
+        "       gdexport-batch [-doc <dir>] [-doc-jobs <n>] [-doc-budget <bytes>] [-tables] [-thunks]\n"
+        "                      -compile-commands <file> [-jobs <n>] <header-list> [-- <clang-arguments>...]\n"
+        "       gdexport-batch -server\n"
+        "\n"
+        "Processes each header in <header-list> (or stdin if '-') in a single process.\n"
+        "Each line of the list is '<header>\\t<output>[\\t<dependency-file>[\\t<manifest-file>[\\t<stats-file>[\\t<interface-file>]]]]'\n"
+        "\n"
+        "With -compile-commands, each header is processed with the command inferred from the compilation\n"
+        "database (compile_commands.json, or the build directory containing it) with <clang-arguments>\n"
+        "added, and -jobs headers are processed in parallel (default is the number of CPUs).\n"
+        "\n"
+        "With -doc-budget, the documentation is rendered as it is parsed, and moved to temporary files\n"
+        "once more than <bytes> are held in memory.\n"
+        "\n"
+        "With -server, processes a request (JSON object) from each line of stdin.\n";
+}
+
+/**
+ * Entry point for the batch driver, which runs GenerateExtensionInterface as the main frontend
+ * action for several header files in one process. All headers share a single FileManager, so
+ * the (godot-cpp) include tree is only looked up once.
+ *
+ * Before processing each header prints ":file <header>" to stdout, followed by the names of the
+ * classes for which documentation is generated (as for the plugin).
+ *
+ * With the "-compile-commands" argument, the command for each header is read from a compilation
+ * database instead, and the headers are processed in parallel (see ProcessDatabase).
+ *
+ * With the "-server" argument, runs as a long-lived server instead (see RunServer).
+ *
+ * @param argc Number of arguments
+ * @param argv The arguments
+ * @return 0 if every header was processed successfully; 1 otherwise
+ */
+int main(int argc, const char** argv)
+{
+    if((argc == 2) && (StringRef(argv[1]) == "-server"))
+    {
+        return RunServer();
+    }
+
+    std::optional<std::string> doc;
+    std::optional<std::string> listFile;
+    std::optional<std::string> compileCommands;
+    unsigned int docJobs = 0;
+    std::optional<std::size_t> docBudget;
+    unsigned int jobs = 0;
+    bool tables = false;
+    bool thunks = false;
+    std::vector<std::string> command;
+    for(int i = 1; i < argc; ++i)
+    {
+        StringRef arg(argv[i]);
+        if(arg == "--")
+        {
+            command.assign(argv + i + 1, argv + argc);
+            break;
+        }
+        else if((arg == "-doc") && (i + 1 < argc))
+        {
+            doc = argv[++i];
+        }
+        else if((arg == "-doc-jobs") && (i + 1 < argc))
+        {
+            if(StringRef(argv[++i]).getAsInteger(10, docJobs))
+            {
+                PrintUsage();
+                return 1;
+            }
+        }
+        else if((arg == "-doc-budget") && (i + 1 < argc))
+        {
+            std::size_t budget;
+            if(StringRef(argv[++i]).getAsInteger(10, budget))
+            {
+                PrintUsage();
+                return 1;
+            }
+            docBudget = budget;
+        }
+        else if((arg == "-compile-commands") && (i + 1 < argc))
+        {
+            compileCommands = argv[++i];
+        }
+        else if((arg == "-jobs") && (i + 1 < argc))
+        {
+            if(StringRef(argv[++i]).getAsInteger(10, jobs))
+            {
+                PrintUsage();
+                return 1;
+            }
+        }
+        else if(arg == "-tables")
+        {
+            tables = true;
+        }
+        else if(arg == "-thunks")
+        {
+            thunks = true;
+        }
+        else if(!listFile && (!arg.starts_with("-") || (arg == "-")))
+        {
+            listFile = arg.str();
+        }
+        else
+        {
+            PrintUsage();
+            return 1;
+        }
+    }
+    if(!listFile || (command.empty() && !compileCommands))
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    auto list = llvm::MemoryBuffer::getFileOrSTDIN(*listFile, true);
+    if(!list)
+    {
+        llvm::errs() << "gdexport-batch: unable to read '" << *listFile << "': " << list.getError().message() << "\n";
+        return 1;
+    }
+    std::vector<BatchHeader> headers;
+    if(!ParseHeaderList((*list)->getBuffer(), tables, thunks, headers))
+    {
+        return 1;
+    }
+
+    if(compileCommands)
+    {
+        auto database = LoadCompilationDatabase(*compileCommands);
+        if(!database)
+        {
+            return 1;
+        }
+        if((jobs != 1) && std::any_of(headers.begin(), headers.end(), [](const BatchHeader& header)
+            {
+                return header.Statistics.has_value();
+            }))
+        {
+            // The statistics are recorded for one translation unit at a time
+            llvm::errs() << "gdexport-batch: statistics files require -jobs 1\n";
+            return 1;
+        }
+        return ProcessDatabase(*database, headers, command, doc, docJobs, docBudget, jobs);
+    }
+
+    IntrusiveRefCntPtr<FileManager> files(new FileManager(FileSystemOptions(), llvm::vfs::getRealFileSystem()));
+    auto pchOperations = std::make_shared<PCHContainerOperations>();
+    int result = 0;
+    for(const auto& header : headers)
+    {
+        if(!ProcessHeader(command, header, doc, docJobs, docBudget, files.get(), pchOperations))
+        {
+            result = 1;
+        }
+    }
+    return result;
+}
@@ -0,0 +1,361 @@
+#!/usr/bin/env python3
+
+# SPDX-FileCopyrightText: 2025 Gridshadows Gaming <https://www.gridshadows.co.uk>
+# SPDX-License-Identifier: Zlib
+
+"""
+Benchmark for gdexport's own performance.
+
+Generates a corpus of synthetic annotated header files (classes with documented methods,
+properties, signals and enums), processes the corpus with `gdexport.generate_all`, and reports
+the results as JSON, for each phase (generating the interface only, and generating the interface
+and documentation):
+  - the wall time and peak RSS (of the clang processes) of `generate_all`
+  - the time to process each header file with clang (from a separate run of each header,
+    with `-ftime-trace`)
+  - the time spent in the gdexport visitors, `GodotType::Parse` and writing the XML
+    documentation files, for each header and in total (from the `-ftime-trace` output)
+
+The time spent escaping the XML is not measured separately (it is too fine grained to trace); it
+is measured on its own by the `escape-benchmark` CMake target.
+
+Requires the plugin to have been built (as for `gdexport.py`), and a built version of the
+[`godot-cpp` Git repository](https://github.com/godotengine/godot-cpp).
+"""
+
+__author__ = "Gridshadows Gaming"
+__copyright__ = "Copyright 2025 Gridshadows Gaming"
+__license__ = "ZLib"
+__version__ = "0.1.0"
+__status__ = "Development"
+
+import json
+import multiprocessing
+import pathlib
+import platform
+import queue
+import sys
+import tempfile
+import time
+import traceback
+
+sys.path.insert(0, str(pathlib.Path(__file__).resolve().parent))
+import gdexport
+
+_SCOPES = {
+    "ExtractInterfaceVisitor" : ["ExtractInterfaceVisitor"],
+    "ExtractDocVisitor"       : ["ExtractDocVisitor::ParseDocumentation", "ExtractDocVisitor::WriteClassFile"],
+    "GodotType::Parse"        : ["GodotType::Parse"],
+    "WriteClassFile"          : ["ExtractDocVisitor::WriteClassFile"],
+    "clang frontend"          : ["Frontend"]
+}
+"""
+The times reported for each header, and the names of the `-ftime-trace` events (from the
+`llvm::TimeTraceScope`s in the plugin, or from clang) they are measured from. The time spent in
+`ExtractInterfaceVisitor` is the whole traversal, so includes the other gdexport times.
+`WriteClassFile` is the part of `ExtractDocVisitor` writing the documentation files (rendering,
+escaping and writing the XML), and is only traced when the documentation is written on the main
+thread (`doc_jobs` is 0)
+"""
+
+def _write_header(path : pathlib.Path, index : int, classes : int, members : int):
+    """
+    Write a synthetic header file for the benchmark
+
+    :param pathlib.Path path: The header file to write
+    :param int index:         The index of the header file (to give each class a unique name)
+    :param int classes:       The number of classes in the header file
+    :param int members:       The number of each kind of member (methods, properties, signals and
+                              enum values) of each class
+    """
+    lines = ["#pragma once", "", "#include <godot_cpp/classes/node.hpp>", "", "namespace bench {", ""]
+    for c in range(classes):
+        name = "Bench{}_{}".format(index, c)
+        lines += [
+            "/**",
+            " * Synthetic class @b {} for the gdexport benchmark.".format(name),
+            " *",
+            " * Detailed description, with characters which must be escaped (<, >, & and \"), and a",
+            " * reference to @ref method:method_0. See also @p prop_0.",
+            " *",
+            " * @note Generated by benchmark.py",
+            " * @since 0.1.0",
+            " */",
+            "class [[godot::class]] {} : public godot::Node".format(name),
+            "{",
+            "    GDCLASS({}, godot::Node)".format(name),
+            "",
+            "protected:",
+            "    static void _bind_methods();",
+            "",
+            "public:",
+            "    /**",
+            "     * Modes of the class",
+            "     */",
+            "    enum [[godot::enum]] Mode",
+            "    {"]
+        for m in range(members):
+            lines += ["        /** Mode value {} of @c Mode */".format(m),
+                      "        MODE_{},".format(m)]
+        lines += ["    };", ""]
+        for m in range(members):
+            lines += [
+                "    /**",
+                "     * Method {} of the class, which @e combines the arguments.".format(m),
+                "     *",
+                "     * @param value The value to combine (must be < 100 & > 0)",
+                "     * @param scale The scale to apply to @a value",
+                "     * @param mode The mode to combine with",
+                "     * @return The combined value",
+                "     */",
+                "    [[godot::method]]",
+                "    double method_{}(int value, double scale, Mode mode) const;".format(m),
+                "",
+                "    /**",
+                "     * Property {} of the class".format(m),
+                "     */",
+                "    [[godot::getter(\"prop_{}\")]]".format(m),
+                "    godot::String get_prop_{}() const;".format(m),
+                "    [[godot::setter(\"prop_{}\")]]".format(m),
+                "    void set_prop_{}(const godot::String& value);".format(m),
+                "",
+                "    /**",
+                "     * Signal {} emitted by the class".format(m),
+                "     *",
+                "     * @param node The node emitting the signal",
+                "     * @param amount The amount the node changed by",
+                "     */",
+                "    [[godot::signal]]",
+                "    void signal_{}(godot::Node* node, double amount);".format(m),
+                ""]
+        lines += ["};", ""]
+    lines += ["} // namespace bench", ""]
+    path.write_text("\n".join(lines), encoding='utf-8')
+
+def generate_corpus(folder : str, headers : int, classes : int, members : int) -> list[str]:
+    """
+    Write a corpus of synthetic header files for the benchmark
+
+    :param str folder:  The folder to write the header files to
+    :param int headers: The number of header files to write
+    :param int classes: The number of classes in each header file
+    :param int members: The number of each kind of member (methods, properties, signals and
+                        enum values) of each class
+
+    :return: The header files
+    """
+    files = []
+    for index in range(headers):
+        path = pathlib.Path(folder) / "bench{}.hpp".format(index)
+        _write_header(path, index, classes, members)
+        files.append(str(path))
+    return files
+
+def _union_duration(intervals : list[tuple[int,int]]) -> int:
+    """
+    Gets the total duration covered by a list of intervals, counting overlapping intervals (e.g.,
+    from recursive scopes) once
+
+    :param list[tuple[int,int]] intervals: The start and end of each interval
+
+    :return: The total duration
+    """
+    total = 0
+    end = None
+    for start,finish in sorted(intervals):
+        if end is None or start >= end:
+            total += finish - start
+            end = finish
+        elif finish > end:
+            total += finish - end
+            end = finish
+    return total
+
+def _trace_times(path : pathlib.Path) -> dict[str,float]:
+    """
+    Read the times reported for a header (see `_SCOPES`) from the output of `-ftime-trace`
+
+    :param pathlib.Path path: The trace file
+
+    :return: The time (in seconds) for each of `_SCOPES`
+    """
+    with open(str(path), encoding='utf-8') as f:
+        events = json.load(f).get("traceEvents", [])
+    intervals = {}
+    for event in events:
+        if event.get("ph") == "X" and "dur" in event:
+            intervals.setdefault(event["name"], []).append((event["ts"], event["ts"] + event["dur"]))
+    return { scope : _union_duration([x for name in names for x in intervals.get(name, [])]) / 1e6
+             for scope,names in _SCOPES.items() }
+
+def _peak_rss() -> int:
+    """
+    Gets the peak RSS of the (finished) child processes, in KiB
+    """
+    import resource
+    rss = resource.getrusage(resource.RUSAGE_CHILDREN).ru_maxrss
+    # macOS reports bytes, while Linux reports KiB
+    return rss // 1024 if platform.system() == "Darwin" else rss
+
+def _run_phase(results, files : list[str], folder : str, options : dict):
+    """
+    Run a phase of the benchmark (in a new process, so the peak RSS is only for this phase), and
+    put the results (or the error, if the phase fails) on the queue
+
+    :param multiprocessing.Queue results: The queue to put the results on
+    :param list[str] files:               The header files to process
+    :param str folder:                    The folder to write the generated files to
+    :param dict options:                  The arguments to pass to `gdexport.generate_all` and
+                                          `gdexport.export_header`
+    """
+    try:
+        results.put(_phase_results(files, pathlib.Path(folder), options))
+    except BaseException:
+        results.put({ "error": traceback.format_exc() })
+        sys.exit(1)
+
+def _phase_results(files : list[str], output : pathlib.Path, options : dict) -> dict:
+    """
+    Run a phase of the benchmark (see `_run_phase`)
+
+    :param list[str] files:      The header files to process
+    :param pathlib.Path output:  The folder to write the generated files to
+    :param dict options:         The arguments to pass to `gdexport.generate_all` and
+                                 `gdexport.export_header`
+
+    :return: The results of the phase
+    """
+    start = time.perf_counter()
+    gdexport.generate_all("bench", files, destination=str(output), quiet=True, **options)
+    wall = time.perf_counter() - start
+    rss = _peak_rss()
+
+    single = {x : y for x,y in options.items() if x not in ["jobs", "batch", "jumbo"]}
+    args = list(single.pop("args", []))
+    headers = []
+    for file in files:
+        trace = output / (pathlib.Path(file).stem + ".trace.json")
+        start = time.perf_counter()
+        gdexport.export_header(file, destination=str(output),
+                               args=args + ["-ftime-trace="+str(trace), "-ftime-trace-granularity=0"],
+                               **single)
+        headers.append({ "header": pathlib.Path(file).name,
+                         "clang_time": time.perf_counter() - start,
+                         "scopes": _trace_times(trace) })
+    totals = { scope : sum(x["scopes"][scope] for x in headers) for scope in _SCOPES }
+    return { "wall_time": wall,
+             "peak_rss_kib": rss,
+             "clang_time": sum(x["clang_time"] for x in headers),
+             "scopes": totals,
+             "headers": headers }
+
+def _phase_result(results, process) -> dict|None:
+    """
+    Wait for the result of a phase of the benchmark, or for the process running the phase to exit
+
+    :param multiprocessing.Queue results:  The queue the result is put on (see `_run_phase`)
+    :param multiprocessing.Process process: The process running the phase
+
+    :return: The result (or error) put on the queue; or None if the process exited without one
+    """
+    while process.exitcode is None:
+        try:
+            return results.get(timeout=1)
+        except queue.Empty:
+            pass
+    # The process flushes the queue before exiting, so a result put just before exiting is available
+    try:
+        return results.get(timeout=1)
+    except queue.Empty:
+        return None
+
+def run_benchmark(headers : int       = 8,
+                  classes : int       = 4,
+                  members : int       = 16,
+                  godot   : str|None  = 'godot-cpp',
+                  clang   : str       = "clang",
+                  jobs    : int|None  = 1,
+                  options : dict|None = None) -> dict:
+    """
+    Run the benchmark on a synthetic corpus
+
+    :param int headers:      The number of header files in the corpus
+    :param int classes:      The number of classes in each header file
+    :param int members:      The number of each kind of member (methods, properties, signals and
+                             enum values) of each class
+    :param str|None godot:   Path to the root of the checkout of the `godot-cpp` repo
+                             (see `gdexport.generate_all`)
+    :param str clang:        Path to the clang executable
+    :param int|None jobs:    Number of clang processes `generate_all` runs in parallel
+    :param dict|None options: Extra arguments to pass to `gdexport.generate_all` (e.g., `tables`)
+
+    :raises RuntimeError: if a phase of the benchmark fails
+
+    :return: The results (see the module documentation), as a JSON serialisable dictionary
+    """
+    options = dict(options or {})
+    options.update(godot=godot, clang=clang)
+    context = multiprocessing.get_context("spawn")
+    phases = {}
+    with tempfile.TemporaryDirectory() as tmp:
+        files = generate_corpus(tmp, headers, classes, members)
+        for phase,documentation in [("interface", None), ("documentation", "doc")]:
+            folder = pathlib.Path(tmp) / phase
+            folder.mkdir()
+            phase_options = dict(options)
+            if documentation:
+                phase_options["documentation"] = str(folder / documentation)
+            results = context.Queue()
+            process = context.Process(target=_run_phase, args=(results, files, str(folder),
+                                                               dict(phase_options, jobs=jobs)))
+            process.start()
+            result = _phase_result(results, process)
+            process.join()
+            if result is None or "error" in result:
+                raise RuntimeError("Benchmark phase '{}' failed{}".format(
+                    phase, ":\n" + result["error"] if result else ""))
+            if process.exitcode != 0:
+                raise RuntimeError("Benchmark phase '{}' failed".format(phase))
+            phases[phase] = result
+    return { "corpus": { "headers": headers, "classes": classes, "members": members },
+             "jobs": jobs,
+             "options": { x : y for x,y in options.items() if x not in ["godot", "clang"] },
+             "phases": phases }
+
+if __name__ == "__main__":
+    import argparse
+
+    parser = argparse.ArgumentParser(description="Benchmark gdexport on a corpus of synthetic header files")
+    parser.add_argument("--godot", metavar="DIR", default="godot-cpp",
+                        help="Path to the godot-cpp checkout (default=godot-cpp)")
+    parser.add_argument("--clang", metavar="EXE", default="clang",
+                        help="Path to the clang executable (default=clang)")
+    parser.add_argument("--headers", metavar="N", type=int, default=8,
+                        help="Number of header files to generate (default=8)")
+    parser.add_argument("--classes", metavar="N", type=int, default=4,
+                        help="Number of classes in each header file (default=4)")
+    parser.add_argument("--members", metavar="N", type=int, default=16,
+                        help="Number of methods, properties, signals and enum values of each class (default=16)")
+    parser.add_argument("--jobs", "-j", metavar="N", type=int, nargs="?", default=1, const=0,
+                        help="Number of clang processes to run in parallel (number of CPUs if no argument specified)")
+    parser.add_argument("--tables", action="store_true", default=False,
+                        help="Register properties and signals from constant tables rather than a call for each")
+    parser.add_argument("--thunks", action="store_true", default=False,
+                        help="Bind methods with generated call and ptrcall functions rather than MethodBind templates")
+    parser.add_argument("--output", "-o", metavar="FILE", default=None,
+                        help="Write the results to the specified JSON file (default=stdout)")
+    args = parser.parse_args()
+
+    results = run_benchmark(headers = args.headers,
+                            classes = args.classes,
+                            members = args.members,
+                            godot = args.godot,
+                            clang = args.clang,
+                            jobs = args.jobs,
+                            options = { "tables": args.tables, "thunks": args.thunks })
+    if args.output:
+        with open(args.output, 'w', encoding='utf-8') as f:
+            json.dump(results, f, indent=2)
+    else:
+        json.dump(results, sys.stdout, indent=2)
+        print()
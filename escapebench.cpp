@@ -0,0 +1,297 @@
+// SPDX-FileCopyrightText: 2025 Gridshadows Gaming <https://www.gridshadows.co.uk>
+// SPDX-License-Identifier: Zlib
+
+// Benchmark of the search for the characters to escape in the XML documentation (see
+// xmlescape.hpp). Checks that the vectorised search finds the same characters as the scalar
+// search, then times both on a generated corpus of documentation text, and writes the results as
+// JSON.
+
+#include "xmlescape.hpp"
+
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+using llvm::StringRef;
+
+/**
+ * The characters which must be escaped in XML
+ */
+static constexpr char Specials[] = { '"', '\'', '<', '>', '&' };
+
+/**
+ * Print the usage of the benchmark
+ */
+static void PrintUsage()
+{
+    llvm::errs() << "Usage: gdexport-escape-bench [-size MiB] [-output file]\n";
+}
+
+/**
+ * Checks both searches find the same character in the text
+ *
+ * @param text The text to search
+ * @param expected The offset of the first character to escape (or the size of the text if none)
+ * @return true if both searches return the expected offset; false, otherwise
+ */
+static bool Check(StringRef text, std::size_t expected)
+{
+    const char* scalar = FindXMLSpecialScalar(text.begin(), text.end());
+    const char* simd = FindXMLSpecial(text.begin(), text.end());
+    if((scalar == text.begin() + expected) && (simd == scalar))
+    {
+        return true;
+    }
+    llvm::errs() << "Mismatch for " << text.size() << " byte(s) at offset "
+        << static_cast<const void*>(text.begin()) << ": expected " << expected << ", scalar "
+        << (scalar - text.begin()) << ", vectorised " << (simd - text.begin()) << "\n";
+    return false;
+}
+
+/**
+ * Checks the vectorised search against the scalar search
+ *
+ * Every character to escape is placed at every offset of every length up to 80 bytes (so across
+ * the 16 byte chunks, and in tails shorter than 16 bytes), after every start alignment, with and
+ * without a second character to escape later in the text, and with the other bytes either plain
+ * text or bytes which only differ from a character to escape in the high bit. Finally, checks
+ * random text.
+ *
+ * @return The number of mismatches
+ */
+static unsigned int CheckEquivalence()
+{
+    unsigned int failures = 0;
+    std::vector<char> buffer(16 + 80 + 16);
+    for(char filler : { 'a', static_cast<char>('&' | 0x80), static_cast<char>('<' | 0x80) })
+    {
+        for(std::size_t align = 0; align < 16; ++align)
+        {
+            for(std::size_t length = 0; length <= 80; ++length)
+            {
+                std::fill(buffer.begin(), buffer.end(), filler);
+                // Characters to escape just outside the text must not be found
+                buffer[align + length] = '&';
+                if(align > 0)
+                {
+                    buffer[align - 1] = '<';
+                }
+                StringRef text(buffer.data() + align, length);
+                failures += !Check(text, length);
+                for(std::size_t position = 0; position < length; ++position)
+                {
+                    for(char special : Specials)
+                    {
+                        buffer[align + position] = special;
+                        failures += !Check(text, position);
+                        if(position + 1 < length)
+                        {
+                            buffer[align + length - 1] = '"';
+                            failures += !Check(text, position);
+                            buffer[align + length - 1] = filler;
+                        }
+                        buffer[align + position] = filler;
+                    }
+                }
+            }
+        }
+    }
+
+    std::mt19937 random(0x6d78);
+    std::uniform_int_distribution<int> bytes(0, 255);
+    std::uniform_int_distribution<std::size_t> lengths(0, 256);
+    std::string text;
+    for(unsigned int i = 0; i < 100000; ++i)
+    {
+        text.resize(lengths(random));
+        for(char& c : text)
+        {
+            // Mostly text without characters to escape, so the matches are spread across chunks
+            c = static_cast<char>(bytes(random));
+            if(IsXMLSpecial(c) && (bytes(random) < 224))
+            {
+                c = 'x';
+            }
+        }
+        std::size_t expected = 0;
+        while((expected < text.size()) && !IsXMLSpecial(text[expected]))
+        {
+            ++expected;
+        }
+        failures += !Check(text, expected);
+    }
+    return failures;
+}
+
+/**
+ * Generates a corpus of documentation text: brief and detailed descriptions, and parameter
+ * descriptions, with the characters to escape as frequent as in typical Doxygen comments
+ *
+ * @param size The approximate total size of the corpus in bytes
+ * @return The text of each comment
+ */
+static std::vector<std::string> GenerateCorpus(std::size_t size)
+{
+    static constexpr StringRef Words[] = {
+        "the", "value", "of", "property", "returns", "node", "signal", "emitted", "when", "is",
+        "set", "to", "a", "and", "or", "used", "by", "method", "specifies", "whether", "Vector2",
+        "String", "Array<int>", "\"name\"", "isn't", "x < y", "a > b", "A & B", "Ref<Resource>",
+        "owner's", "[code]true[/code]", "index", "in", "range", "from", "0", "size()",
+    };
+    static constexpr std::size_t Lengths[] = { 40, 120, 400, 1600 };
+
+    std::mt19937 random(0x9e37);
+    std::uniform_int_distribution<std::size_t> word(0, std::size(Words) - 1);
+    std::uniform_int_distribution<std::size_t> length(0, std::size(Lengths) - 1);
+    std::vector<std::string> corpus;
+    std::size_t total = 0;
+    while(total < size)
+    {
+        std::string text;
+        std::size_t target = Lengths[length(random)];
+        while(text.size() < target)
+        {
+            text += Words[word(random)];
+            text += ' ';
+        }
+        total += text.size();
+        corpus.push_back(std::move(text));
+    }
+    return corpus;
+}
+
+/**
+ * Times a search on the corpus: finds every character to escape in every comment, as EscapeXML
+ * does
+ *
+ * @param corpus The corpus of documentation text
+ * @param find The search to time
+ * @param found Set to the number of characters to escape found
+ * @return The time taken, in seconds (the fastest of several runs)
+ */
+static double TimeSearch(const std::vector<std::string>& corpus,
+    const char* (*find)(const char*, const char*), std::size_t& found)
+{
+    double best = 0.0;
+    for(unsigned int run = 0; run < 5; ++run)
+    {
+        auto start = std::chrono::steady_clock::now();
+        found = 0;
+        for(const std::string& text : corpus)
+        {
+            const char* end = text.data() + text.size();
+            for(const char* pos = find(text.data(), end); pos != end; pos = find(pos + 1, end))
+            {
+                ++found;
+            }
+        }
+        double time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if((run == 0) || (time < best))
+        {
+            best = time;
+        }
+    }
+    return best;
+}
+
+/**
+ * Returns the name of the vectorised search for the target
+ *
+ * @return The instruction set used by FindXMLSpecial
+ */
+static StringRef VectorName()
+{
+#if defined(GDEXPORT_SSE2)
+    return "sse2";
+#elif defined(GDEXPORT_NEON)
+    return "neon";
+#else
+    return "scalar";
+#endif
+}
+
+int main(int argc, const char** argv)
+{
+    std::size_t sizeMiB = 64;
+    std::string output = "-";
+    for(int i = 1; i < argc; ++i)
+    {
+        StringRef arg(argv[i]);
+        if((arg == "-size") && (i + 1 < argc))
+        {
+            if(StringRef(argv[++i]).getAsInteger(10, sizeMiB))
+            {
+                PrintUsage();
+                return 1;
+            }
+        }
+        else if((arg == "-output") && (i + 1 < argc))
+        {
+            output = argv[++i];
+        }
+        else
+        {
+            PrintUsage();
+            return 1;
+        }
+    }
+
+    unsigned int failures = CheckEquivalence();
+    if(failures != 0)
+    {
+        llvm::errs() << failures << " mismatch(es) between the vectorised and scalar search\n";
+        return 1;
+    }
+
+    std::vector<std::string> corpus = GenerateCorpus(sizeMiB << 20);
+    std::size_t bytes = 0;
+    for(const std::string& text : corpus)
+    {
+        bytes += text.size();
+    }
+    std::size_t scalarFound;
+    std::size_t vectorFound;
+    double scalar = TimeSearch(corpus, FindXMLSpecialScalar, scalarFound);
+    double vector = TimeSearch(corpus, FindXMLSpecial, vectorFound);
+    if(scalarFound != vectorFound)
+    {
+        llvm::errs() << "The vectorised search found " << vectorFound
+            << " character(s) to escape in the corpus, the scalar search " << scalarFound << "\n";
+        return 1;
+    }
+
+    std::error_code error;
+    llvm::raw_fd_ostream os(output, error, llvm::sys::fs::OF_Text);
+    if(error)
+    {
+        llvm::errs() << "Unable to write " << output << ": " << error.message() << "\n";
+        return 1;
+    }
+    llvm::json::OStream json(os, 2);
+    json.object([&]
+    {
+        json.attribute("vector", VectorName());
+        json.attribute("comments", static_cast<int64_t>(corpus.size()));
+        json.attribute("bytes", static_cast<int64_t>(bytes));
+        json.attribute("escaped", static_cast<int64_t>(scalarFound));
+        json.attributeObject("scalar", [&]
+        {
+            json.attribute("seconds", scalar);
+            json.attribute("mib_per_second", (bytes / 1048576.0) / scalar);
+        });
+        json.attributeObject("vectorised", [&]
+        {
+            json.attribute("seconds", vector);
+            json.attribute("mib_per_second", (bytes / 1048576.0) / vector);
+        });
+        json.attribute("speedup", scalar / vector);
+    });
+    os << "\n";
+    return 0;
+}
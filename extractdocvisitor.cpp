@@ -2,8 +2,17 @@
 // SPDX-License-Identifier: Zlib
 
 #include "extractdocvisitor.hpp"
+#include "statistics.hpp"
 #include "utilities.hpp"
+#include "xmlescape.hpp"
 
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/Threading.h"
+
+#include <algorithm>
+#include <array>
 #include <filesystem>
 
 // TODO: Ensure all text from comments is passed through EscapeXML
@@ -38,38 +47,40 @@ inline XMLEscape EscapeXML(const StringRef& str)
 /**
  * Performs the EscapeXML functor to write to the stream
  *
+ * Runs of text without special characters are written to the stream in a single write.
+ *
  * @param os Stream to write to
  * @param escape The result of EscapeXML
  * @return The stream
  */
 llvm::raw_ostream& operator<<(llvm::raw_ostream& os, const XMLEscape& escape)
 {
-    static constexpr const char* g_special = "\"'<>&";
-    StringRef::size_type start = 0;
-    for(auto pos = escape.Str.find_first_of(g_special); pos != StringRef::npos; pos = escape.Str.find_first_of(g_special, start))
+    const char* start = escape.Str.begin();
+    const char* end = escape.Str.end();
+    for(const char* pos = FindXMLSpecial(start, end); pos != end; pos = FindXMLSpecial(start, end))
     {
-        os << escape.Str.substr(start, pos-start);
-        switch(escape.Str[pos])
+        os.write(start, pos - start);
+        switch(*pos)
         {
-            case g_special[0]:
+            case '"':
                 os << "&quot;";
                 break;
-            case g_special[1]:
+            case '\'':
                 os << "&apos;";
                 break;
-            case g_special[2]:
+            case '<':
                 os << "&lt;";
                 break;
-            case g_special[3]:
+            case '>':
                 os << "&gt;";
                 break;
-            case g_special[4]:
+            case '&':
                 os << "&amp;";
                 break;
         }
         start = pos+1;
     }
-    return os << escape.Str.substr(start);
+    return os.write(start, end - start);
 }
 
 /**
@@ -90,11 +101,27 @@ constexpr bool IsDifferentLanguage(ParagraphType current, ParagraphType next)
  * Gets a segment of BBCode to write a paragraph title
  *
  * @param title The title
- * @return The BB code
+ * @return The BB code (as the spans of text to write in order)
+ */
+inline std::array<StringRef, 3> Title(const StringRef& title)
+{
+    return {"[b]", title, ":[/b] "};
+}
+
+/**
+ * Writes the spans of a prefix to the XML documentation file
+ *
+ * @param stream The stream for the documentation file
+ * @param prefix The spans of text of the prefix
+ * @return The stream
  */
-std::string Title(const std::string& title)
+llvm::raw_ostream& WritePrefix(llvm::raw_ostream& stream, llvm::ArrayRef<StringRef> prefix)
 {
-    return "[b]" + title + ":[/b] ";
+    for(const auto& part : prefix)
+    {
+        stream << EscapeXML(part);
+    }
+    return stream;
 }
 
 /**
@@ -106,7 +133,8 @@ std::string Title(const std::string& title)
  * @param prefix Prefix to output ONLY if there is data to output in the paragraph
  * @return true if the paragraph was written (had data); false, otherwise
  */
-bool WriteSingleLine(llvm::raw_ostream& stream, const Paragraph& para, std::size_t indent, const std::string& prefix = "")
+bool WriteSingleLine(llvm::raw_ostream& stream, const Paragraph& para, std::size_t indent,
+    llvm::ArrayRef<StringRef> prefix = {})
 {
     bool written = false;
     auto end = para.Data.end();
@@ -114,11 +142,11 @@ bool WriteSingleLine(llvm::raw_ostream& stream, const Paragraph& para, std::size
     if(it != end)
     {
         --end;
-        StringRef last = StringRef{*end}.rtrim();
+        StringRef last = end->rtrim();
         while((it != end) && last.empty())
         {
             --end;
-            last = StringRef{*end}.rtrim();
+            last = end->rtrim();
         }
         for(; it != end; ++it)
         {
@@ -127,7 +155,7 @@ bool WriteSingleLine(llvm::raw_ostream& stream, const Paragraph& para, std::size
             {
                 if(!written)
                 {
-                    stream.indent(indent) << EscapeXML(prefix);
+                    WritePrefix(stream.indent(indent), prefix);
                     str = str.ltrim();
                 }
                 stream << EscapeXML(str);
@@ -138,7 +166,7 @@ bool WriteSingleLine(llvm::raw_ostream& stream, const Paragraph& para, std::size
         {
             if(!written)
             {
-                stream.indent(indent) << EscapeXML(prefix);
+                WritePrefix(stream.indent(indent), prefix);
                 last = last.ltrim();
             }
             stream << EscapeXML(last);
@@ -160,20 +188,18 @@ bool WriteVerbatim(llvm::raw_ostream& stream, const Paragraph& para, std::size_t
 {
     bool written = false;
     std::size_t stripAmount = std::numeric_limits<std::size_t>::max();
-    for(const auto& part : para.Data)
+    for(const auto& str : para.Data)
     {
-        StringRef str = part;
         auto wsLen = str.find_first_not_of(" \t\n\v\f\r");
         if(wsLen != StringRef::npos)
         {
             stripAmount = std::min(stripAmount, wsLen);
         }
     }
-    for(const auto& part : para.Data)
+    for(const auto& str : para.Data)
     {
-        StringRef str = part;
         stream.indent(indent);
-        if(part.size() > stripAmount)
+        if(str.size() > stripAmount)
         {
             stream << EscapeXML(str.substr(stripAmount).rtrim()) << '\n';
         }
@@ -195,7 +221,8 @@ bool WriteVerbatim(llvm::raw_ostream& stream, const Paragraph& para, std::size_t
  * @param prefix The prefix to prepend to the *first* paragraph which is written
  * @return true if the paragraphs were written (at least one paragraph had data); false, otherwise
  */
-bool Write(llvm::raw_ostream& stream, const Paragraphs& paras, std::size_t indent, const std::string& prefix = "")
+bool Write(llvm::raw_ostream& stream, const Paragraphs& paras, std::size_t indent,
+    llvm::ArrayRef<StringRef> prefix = {})
 {
     // TODO: Continue line
     auto end = paras.end();
@@ -248,7 +275,8 @@ bool Write(llvm::raw_ostream& stream, const Paragraphs& paras, std::size_t inden
                 }
                 case ParagraphType::Normal:
                 default:
-                    newPara = WriteSingleLine(stream, *it, indent, (newPara) ? "" : prefix) || newPara;
+                    newPara = WriteSingleLine(stream, *it, indent,
+                        (newPara) ? llvm::ArrayRef<StringRef>() : prefix) || newPara;
                     break;
             }
         }
@@ -285,11 +313,11 @@ llvm::raw_ostream& WriteOptionalSection(llvm::raw_ostream& os, bool& newPara,
 /**
  * Parse an `@ref`
  *
+ * @param para The paragraph to append the BBCode for the reference to
  * @param ref The reference to parse
  * @param className The name of the current class to resolve references against
- * @return The BBCode for the reference
  */
-std::string ParseReference(const StringRef& ref, const StringRef& className)
+void ParseReference(Paragraph& para, const StringRef& ref, const StringRef& className)
 {
     auto sep = ref.find(':');
     if(sep != StringRef::npos)
@@ -298,9 +326,22 @@ std::string ParseReference(const StringRef& ref, const StringRef& className)
         if(type == "operator")
         {
             auto end = ref.find('.', sep+1);
-            return (end != StringRef::npos)
-                ? "[operator " + std::string{ref.substr(sep+1, end-sep)} + "operator " + std::string{ref.substr(end+1)} + "]"
-                : "[operator " + std::string{className} + ".operator " + std::string{ref.substr(sep+1)} + "]";
+            if(end != StringRef::npos)
+            {
+                para += "[operator ";
+                para += ref.substr(sep+1, end-sep);
+                para += "operator ";
+                para += ref.substr(end+1);
+            }
+            else
+            {
+                para += "[operator ";
+                para += className;
+                para += ".operator ";
+                para += ref.substr(sep+1);
+            }
+            para += "]";
+            return;
         }
         else if((type == "annotation")
             || (type == "constant")
@@ -312,12 +353,22 @@ std::string ParseReference(const StringRef& ref, const StringRef& className)
             || (type == "theme_item"))
         {
             auto end = ref.find('.', sep+1);
-            return (end != StringRef::npos)
-                ? '[' + std::string{type} + ' ' + std::string{ref.substr(sep+1)} + ']'
-                : '[' + std::string{type} + ' ' + std::string{className} + '.' + std::string{ref.substr(sep+1)} + ']';
+            para += "[";
+            para += type;
+            para += " ";
+            if(end == StringRef::npos)
+            {
+                para += className;
+                para += ".";
+            }
+            para += ref.substr(sep+1);
+            para += "]";
+            return;
         }
     }
-    return "[" + std::string{ref} + "]";
+    para += "[";
+    para += ref;
+    para += "]";
 }
 
 /**
@@ -372,22 +423,30 @@ Paragraph ParseComments(T* comment, const StringRef& className, const comments::
                 comments::InlineCommandComment* comment = dyn_cast<comments::InlineCommandComment>(*it);
                 auto numArgs = comment->getNumArgs();
                 auto cmd = comment->getCommandName(traits);
-                auto arg = (numArgs > 0) ? std::string{comment->getArgText(0)} : "";
+                auto arg = (numArgs > 0) ? comment->getArgText(0) : StringRef();
                 if(cmd == "a")
                 {
-                    result += "[param " + arg + "]";
+                    result += "[param ";
+                    result += arg;
+                    result += "]";
                 }
                 else if(cmd == "b")
                 {
-                    result += "[b]" + arg + "[/b]";
+                    result += "[b]";
+                    result += arg;
+                    result += "[/b]";
                 }
                 else if(cmd == "c")
                 {
-                    result += "[code]" + arg + "[/code]";
+                    result += "[code]";
+                    result += arg;
+                    result += "[/code]";
                 }
                 else if((cmd == "e") || (cmd == "em"))
                 {
-                    result += "[i]" + arg + "[/i]";
+                    result += "[i]";
+                    result += arg;
+                    result += "[/i]";
                 }
                 else if(cmd == "n")
                 {
@@ -395,11 +454,15 @@ Paragraph ParseComments(T* comment, const StringRef& className, const comments::
                 }
                 else if(cmd == "p")
                 {
-                    result += "[member " + std::string{className} + "." + arg + "]";
+                    result += "[member ";
+                    result += className;
+                    result += ".";
+                    result += arg;
+                    result += "]";
                 }
                 else if(cmd == "ref")
                 {
-                    result += ParseReference(arg, className);
+                    ParseReference(result, arg, className);
                 }
                 else if(!arg.empty())
                 {
@@ -409,7 +472,8 @@ Paragraph ParseComments(T* comment, const StringRef& className, const comments::
                 {
                     for(unsigned int i = 1; i != numArgs; ++i)
                     {
-                        result += " " + std::string{comment->getArgText(i)};
+                        result += " ";
+                        result += comment->getArgText(i);
                     }
                 }
                 break;
@@ -467,9 +531,8 @@ llvm::raw_ostream& operator<<(llvm::raw_ostream& os, ParagraphType type)
 
 bool Paragraph::empty() const
 {
-    for(const auto& data : Data)
+    for(const auto& str : Data)
     {
-        StringRef str{data};
         if(!str.ltrim().empty())
         {
             return false;
@@ -478,35 +541,28 @@ bool Paragraph::empty() const
     return true;
 }
 
-void Paragraph::push_front(const std::string& str)
+void Paragraph::push_front(const StringRef& str)
+{
+    push_front(llvm::ArrayRef<StringRef>(str));
+}
+
+void Paragraph::push_front(llvm::ArrayRef<StringRef> strs)
 {
     if(!Data.empty())
     {
         auto& first = Data.front();
         auto pos = first.find_first_not_of(" \t\n\v\f\r");
-        if(pos != std::string::npos)
+        if(pos != StringRef::npos)
         {
             first = first.substr(pos);
         }
     }
-    Data.push_front(str);
-}
-
-Paragraph& operator+=(Paragraph& para, const std::string& text)
-{
-    para.Data.push_back(text);
-    return para;
+    Data.insert(Data.begin(), strs.begin(), strs.end());
 }
 
 Paragraph& operator+=(Paragraph& para, const StringRef& text)
 {
-    para.Data.push_back(std::string{text});
-    return para;
-}
-
-Paragraph& operator+=(Paragraph& para, const char* text)
-{
-    para.Data.emplace_back(text);
+    para.Data.push_back(text);
     return para;
 }
 
@@ -514,7 +570,8 @@ Paragraph& operator+=(Paragraph& para, Paragraph&& text)
 {
     if(para.Type == text.Type)
     {
-        para.Data.splice(para.Data.end(), text.Data);
+        para.Data.append(text.Data.begin(), text.Data.end());
+        text.Data.clear();
     }
     // TODO: else Error
     return para;
@@ -542,6 +599,7 @@ Paragraphs& operator+=(Paragraphs& paras, Paragraph&& para)
 
 ParsedDocumentation::ParsedDocumentation(const StringRef& className, comments::FullComment* doc, const comments::CommandTraits& traits)
 {
+    PhaseScope scope(Phase::Documentation, "ExtractDocVisitor::ParseDocumentation");
     if(doc)
     {
         bool hasBriefTag = false;
@@ -644,11 +702,11 @@ llvm::raw_ostream& ParsedDocumentation::WriteDetailed(llvm::raw_ostream& os, boo
             {
                 os << "\n";
             }
-            os.indent(indent) << Title("Parameters");
+            WritePrefix(os.indent(indent), Title("Parameters"));
             for(const auto& param : ParameterDescs)
             {
                 WriteSingleLine(os << "\n", param.Description, indent,
-                    u8"\u00A0\u2022\u00A0\u00A0[b][code]" + param.Name + "[/code]:[/b] ");
+                    {u8"\u00A0\u2022\u00A0\u00A0[b][code]", param.Name, "[/code]:[/b] "});
             }
             newPara = true;
         }
@@ -670,12 +728,12 @@ llvm::raw_ostream& ParsedDocumentation::WriteDetailed(llvm::raw_ostream& os, boo
                 {
                     os << "\n";
                 }
-                os.indent(indent) << Title("Return");
+                WritePrefix(os.indent(indent), Title("Return"));
             }
             for(const auto& values : ReturnValues)
             {
                 WriteSingleLine(os << "\n", values.Description, indent,
-                    u8"\u00A0\u2022\u00A0\u00A0[b][code]" + values.Name + "[/code]:[/b] ");
+                    {u8"\u00A0\u2022\u00A0\u00A0[b][code]", values.Name, "[/code]:[/b] "});
             }
         }
     }
@@ -724,14 +782,7 @@ void ParsedDocumentation::ParseBlock(const StringRef& className, const comments:
         {
             if(!hasBriefTag)
             {
-                if(Detailed.empty())
-                {
-                    Detailed += Brief;
-                }
-                else
-                {
-                    Detailed.push_front(Brief);
-                }
+                Detailed.insert(Detailed.begin(), std::move(Brief));
                 Brief = std::move(paragraph);
             }
             else
@@ -787,7 +838,7 @@ void ParsedDocumentation::ParseBlock(const StringRef& className, const comments:
     {
         if(block->getNumArgs() > 0)
         {
-            paragraph.push_front(Title(std::string{block->getArgText(0)}));
+            paragraph.push_front(Title(block->getArgText(0)));
         }
         Detailed += std::move(paragraph);
     }
@@ -807,7 +858,7 @@ void ParsedDocumentation::ParseBlock(const StringRef& className, const comments:
     {
         if(block->getNumArgs() > 0)
         {
-            ReturnValues.emplace_back(std::string{block->getArgText(0)}, std::move(paragraph));
+            ReturnValues.emplace_back(block->getArgText(0), std::move(paragraph));
         }
         else
         {
@@ -825,27 +876,25 @@ void ParsedDocumentation::ParseBlock(const StringRef& className, const comments:
         auto end = paragraph.Data.end();
         for(; it != end; ++it)
         {
-            StringRef str(*it);
-            if(!str.ltrim().empty())
+            if(!it->ltrim().empty())
             {
                 break;
             }
         }
         if(it != end)
         {
-            std::string url;
-            StringRef str(*it);
-            str = str.trim();
+            StringRef url;
+            StringRef str = it->trim();
             auto pos = str.find_first_of(" \t\n\v\f\r");
             if(pos == StringRef::npos)
             {
-                url = std::string{str};
+                url = str;
                 paragraph.Data.erase(it);
             }
             else
             {
-                url = std::string{str.substr(0, pos)};
-                *it = std::string{str.substr(pos+1).ltrim()};
+                url = str.substr(0, pos);
+                *it = str.substr(pos+1).ltrim();
             }
             Tutorials.emplace_back(url, std::move(paragraph));
         }
@@ -914,170 +963,407 @@ void ParsedDocumentation::ParseVerbatim(const StringRef& command, comments::Verb
 void ExtractDocVisitor::ProcessStartClass(const StringRef& name, CXXRecordDecl* declaration, bool tool)
 {
     ExtractInterfaceVisitor::ProcessStartClass(name, declaration, tool);
-    auto path = (root / (name.str() + ".xml")).generic_string();
-    std::error_code err;
-    file.reset(new llvm::raw_fd_stream(path, err));
-    if(err)
+    current = std::make_unique<ClassDoc>(name, (root / (name.str() + ".xml")).generic_string(),
+        declaration->getLocation(), Context().getLocalCommentForDeclUncached(declaration),
+        Context().getCommentCommandTraits());
+    // TODO: We assume the first class is the godot class we are inheriting from
+    for(const auto& base : declaration->bases())
     {
-        file.reset();
-        GenerateError(Context(), declaration->getLocation(),
-            "Unable to open output XML file for documentation for class '%0'\n"
-            "    File:  %1\n"
-            "    Error: %3 (%2)", name, path, err.value(), err.message());
+        auto cls = GetUnderlyingType(base.getType())->getAsCXXRecordDecl();
+        if(cls)
+        {
+            current->Inherits.push_back(cls->getName());
+        }
     }
-    if(file)
+}
+
+void ExtractDocVisitor::ProcessEndClass(const StringRef& name, CXXRecordDecl* declaration)
+{
+    ExtractInterfaceVisitor::ProcessEndClass(name, declaration);
+    if(current)
     {
-        *file << "<?xml version=\"1.0\" encoding=\"UTF-8\" ?>\n"
-                << "<class name=\"" << name << "\"";
-        // TODO: We assume the first class is the godot class we are inheriting from
-        for(const auto& base : declaration->bases())
+        if(docJobs == 0)
         {
-            auto cls = GetUnderlyingType(base.getType())->getAsCXXRecordDecl();
-            if(cls)
+            auto err = WriteClassFile(*current);
+            if(err)
             {
-                *file << " inherits=\"" << cls->getName() << "\"";
+                ReportWriteError(*current, err);
             }
+            buffered -= BufferedSize(*current);
         }
-
-        *file << " xmlns:xsi=\"http://www.w3.org/2001/XMLSchema-instance\""
-              << " xsi:noNamespaceSchemaLocation=\"https://raw.githubusercontent.com/godotengine/godot/master/doc/class.xsd\"";
-
-        ParsedDocumentation doc(name, Context().getLocalCommentForDeclUncached(declaration),
-            Context().getCommentCommandTraits());
-        doc.WriteAttributes(*file);
-        *file << ">\n";
-        *file << "    <brief_description>\n";
-        WriteSingleLine(*file, doc.Brief, 8);
-        *file << "\n    </brief_description>\n"
-              << "    <description>\n";
-        doc.WriteDetailed(*file, false, false, 8);
-        *file << "\n    </description>\n"
-              << "    <tutorials>\n";
-        for(const auto& tutorial : doc.Tutorials)
+        else
         {
-            *file << "        <link";
-            if(!tutorial.Title.empty())
-            {
-                *file << " title=\"";
-                WriteSingleLine(*file, tutorial.Title, 0);
-                *file << "\"";
-            }
-            *file << '>' << EscapeXML(tutorial.URL) << "</link>\n";
+            pending.push_back(std::move(current));
         }
-        *file  << "    </tutorials>\n";
+        current.reset();
     }
 }
 
-void ExtractDocVisitor::ProcessEndClass(const StringRef& name, CXXRecordDecl* declaration)
+void ExtractDocVisitor::EndTranslationUnit()
 {
-    ExtractInterfaceVisitor::ProcessEndClass(name, declaration);
-    if(file)
+    if(!pending.empty())
     {
-        *file << "    <methods>\n";
-        for(const auto& method : methods)
+        std::vector<std::error_code> errors(pending.size());
         {
-            // TODO: default, & returns_error
-            *file << "        <method name=\"" << method.first << "\"";
-            if(!method.second.Qualifiers.empty())
-            {
-                *file << " qualifiers=\"" << method.second.Qualifiers << "\"";
-            }
-            method.second.WriteAttributes(*file);
-            *file << ">\n";
-            if(!method.second.ReturnType)
-            {
-                *file << "            <return type=\"void\"/>\n";
-            }
-            else
-            {
-                *file << "            <return type=\"" << method.second.ReturnType->TypeName;
-                if(!method.second.ReturnType->EnumName.empty())
-                {
-                    *file << "\" enum=\"" << method.second.ReturnType->EnumName
-                        << "\" is_bitfield=\"" << method.second.ReturnType->IsBitfield;;
-                }
-                *file << "\"/>\n";
-            }
-            std::size_t index = 0;
-            for(const auto& param : method.second.Arguments)
+            llvm::DefaultThreadPool pool(llvm::hardware_concurrency(docJobs));
+            for(std::size_t i = 0; i != pending.size(); ++i)
             {
-                *file << "            <param index=\"" << index << "\" name=\"" << param.Name
-                      << "\" type=\"" << param.Type.TypeName;
-                if(!param.Type.EnumName.empty())
-                {
-                    *file << "\" enum=\"" << param.Type.EnumName << "\" is_bitfield=\"" << param.Type.IsBitfield;
-                }
-                *file << "\"/>\n";
-                ++index;
+                pool.async([this, &errors, i]()
+                    {
+                        errors[i] = WriteClassFile(*pending[i]);
+                    });
             }
-            *file << "            <description>\n";
-            method.second.WriteDetailed(*file, true, true, 16);
-            *file << "\n            </description>\n        </method>\n";
+            pool.wait();
         }
-        *file << "    </methods>\n    <members>\n";
-        for(const auto& property : properties)
+        // Diagnostics are only reported from this thread
+        for(std::size_t i = 0; i != pending.size(); ++i)
         {
-            // TODO: default
-            *file << "        <member name=\"" << property.first << "\" type=\""
-                  << property.second.Property.Type.TypeName << "\" setter=\""
-                  << property.second.Property.Setter << "\" getter=\""
-                  << property.second.Property.Getter << "\"";
-            if(!property.second.Property.Type.EnumName.empty())
+            if(errors[i])
             {
-                *file << " enum=\"" << property.second.Property.Type.EnumName << "\" is_bitfield=\""
-                    << property.second.Property.Type.IsBitfield << "\"";
+                ReportWriteError(*pending[i], errors[i]);
             }
-            if(property.second.Documentation)
-            {
-                property.second.Documentation->WriteAttributes(*file);
-                *file << ">\n";
-                property.second.Documentation->WriteDetailed(*file, true, false, 12);
-                *file  << "\n        </member>\n";
-            }
-            else
+        }
+        pending.clear();
+        buffered = 0;
+    }
+    ExtractInterfaceVisitor::EndTranslationUnit();
+}
+
+std::error_code ExtractDocVisitor::WriteClassFile(const ClassDoc& cls)
+{
+    // Only traced on the main thread (the profiler is not initialised for the pool threads)
+    PhaseScope scope(Phase::Documentation, "ExtractDocVisitor::WriteClassFile", cls.Name);
+    if(cls.Spilled())
+    {
+        // Written through a temporary file, so the XML moved to temporary files is not read back
+        // into memory
+        return WriteFileIfChanged(cls.Path, [&cls](llvm::raw_ostream& os)
             {
-                *file << "/>\n";
-            }
+                return WriteClass(os, cls);
+            });
+    }
+    llvm::SmallString<0> content;
+    llvm::raw_svector_ostream os(content);
+    if(auto err = WriteClass(os, cls))
+    {
+        return err;
+    }
+    return WriteFileIfChanged(cls.Path, content);
+}
+
+void ExtractDocVisitor::ReportWriteError(const ClassDoc& cls, const std::error_code& err)
+{
+    GenerateError(Context(), cls.Location,
+        "Unable to write output XML file for documentation for class '%0'\n"
+        "    File:  %1\n"
+        "    Error: %3 (%2)", cls.Name, cls.Path, err.value(), err.message());
+}
+
+std::error_code ExtractDocVisitor::WriteClass(llvm::raw_ostream& os, const ClassDoc& cls)
+{
+    const auto& doc = cls.Documentation;
+    os << "<?xml version=\"1.0\" encoding=\"UTF-8\" ?>\n"
+       << "<class name=\"" << cls.Name << "\"";
+    for(const auto& base : cls.Inherits)
+    {
+        os << " inherits=\"" << base << "\"";
+    }
+
+    os << " xmlns:xsi=\"http://www.w3.org/2001/XMLSchema-instance\""
+       << " xsi:noNamespaceSchemaLocation=\"https://raw.githubusercontent.com/godotengine/godot/master/doc/class.xsd\"";
+
+    doc.WriteAttributes(os);
+    os << ">\n";
+    os << "    <brief_description>\n";
+    WriteSingleLine(os, doc.Brief, 8);
+    os << "\n    </brief_description>\n"
+       << "    <description>\n";
+    doc.WriteDetailed(os, false, false, 8);
+    os << "\n    </description>\n"
+       << "    <tutorials>\n";
+    for(const auto& tutorial : doc.Tutorials)
+    {
+        os << "        <link";
+        if(!tutorial.Title.empty())
+        {
+            os << " title=\"";
+            WriteSingleLine(os, tutorial.Title, 0);
+            os << "\"";
         }
-        *file << "    </members>\n    <signals>\n";
-        for(const auto& signal : signals)
+        os << '>' << EscapeXML(tutorial.URL) << "</link>\n";
+    }
+    os  << "    </tutorials>\n";
+
+    // When streaming the documentation, the maps are empty, and each section is already rendered
+    std::error_code err;
+    os << "    <methods>\n";
+    for(const auto& method : cls.Methods)
+    {
+        WriteMethod(os, method.first, method.second);
+    }
+    if(!err)
+    {
+        err = WriteSection(os, cls.Sections[MethodsSection]);
+    }
+    os << "    </methods>\n    <members>\n";
+    for(const auto& property : cls.Properties)
+    {
+        WriteMember(os, property.first, property.second);
+    }
+    if(!err)
+    {
+        err = WriteSection(os, cls.Sections[MembersSection]);
+    }
+    os << "    </members>\n    <signals>\n";
+    for(const auto& signal : cls.Signals)
+    {
+        WriteSignal(os, signal.first, signal.second);
+    }
+    if(!err)
+    {
+        err = WriteSection(os, cls.Sections[SignalsSection]);
+    }
+    os << "    </signals>\n    <constants>\n";
+    for(const auto& constant : cls.Constants)
+    {
+        WriteConstant(os, constant.first, constant.second);
+    }
+    if(!err)
+    {
+        err = WriteSection(os, cls.Sections[ConstantsSection]);
+    }
+    os << "    </constants>\n</class>\n";
+    return err;
+}
+
+void ExtractDocVisitor::WriteMethod(llvm::raw_ostream& os, const StringRef& name, const MethodDoc& method)
+{
+    // TODO: default, & returns_error
+    os << "        <method name=\"" << name << "\"";
+    if(!method.Qualifiers.empty())
+    {
+        os << " qualifiers=\"" << method.Qualifiers << "\"";
+    }
+    method.WriteAttributes(os);
+    os << ">\n";
+    if(!method.ReturnType)
+    {
+        os << "            <return type=\"void\"/>\n";
+    }
+    else
+    {
+        os << "            <return type=\"" << method.ReturnType->TypeName;
+        if(!method.ReturnType->EnumName.empty())
         {
-            *file << "        <signal name=\"" << signal.first << "\"";
-            signal.second.WriteAttributes(*file);
-            *file << ">\n";
-            std::size_t index = 0;
-            for(const auto& param : signal.second.Arguments)
-            {
-                *file << "            <param index=\"" << index << "\" name=\"" << param.Name
-                      << "\" type=\"" << param.Type.TypeName << "\"/>\n";
-                ++index;
-            }
-            *file << "            <description>\n";
-            signal.second.WriteDetailed(*file, true, true, 16);
-            *file << "\n            </description>\n        </signal>\n";
+            os << "\" enum=\"" << method.ReturnType->EnumName
+                << "\" is_bitfield=\"" << method.ReturnType->IsBitfield;;
+        }
+        os << "\"/>\n";
+    }
+    std::size_t index = 0;
+    for(const auto& param : method.Arguments)
+    {
+        os << "            <param index=\"" << index << "\" name=\"" << param.Name
+           << "\" type=\"" << param.Type.TypeName;
+        if(!param.Type.EnumName.empty())
+        {
+            os << "\" enum=\"" << param.Type.EnumName << "\" is_bitfield=\"" << param.Type.IsBitfield;
         }
-        *file << "    </signals>\n    <constants>\n";
-        for(const auto& constant : constants)
+        os << "\"/>\n";
+        ++index;
+    }
+    os << "            <description>\n";
+    method.WriteDetailed(os, true, true, 16);
+    os << "\n            </description>\n        </method>\n";
+}
+
+void ExtractDocVisitor::WriteMember(llvm::raw_ostream& os, const StringRef& name, const PropertyDoc& property)
+{
+    // TODO: default
+    os << "        <member name=\"" << name << "\" type=\""
+       << property.Property.Type.TypeName << "\" setter=\""
+       << property.Property.Setter << "\" getter=\""
+       << property.Property.Getter << "\"";
+    if(!property.Property.Type.EnumName.empty())
+    {
+        os << " enum=\"" << property.Property.Type.EnumName << "\" is_bitfield=\""
+           << property.Property.Type.IsBitfield << "\"";
+    }
+    if(property.Documentation)
+    {
+        property.Documentation->WriteAttributes(os);
+        os << ">\n";
+        property.Documentation->WriteDetailed(os, true, false, 12);
+        os  << "\n        </member>\n";
+    }
+    else
+    {
+        os << "/>\n";
+    }
+}
+
+void ExtractDocVisitor::WriteSignal(llvm::raw_ostream& os, const StringRef& name, const FunctionDoc& signal)
+{
+    os << "        <signal name=\"" << name << "\"";
+    signal.WriteAttributes(os);
+    os << ">\n";
+    std::size_t index = 0;
+    for(const auto& param : signal.Arguments)
+    {
+        os << "            <param index=\"" << index << "\" name=\"" << param.Name
+           << "\" type=\"" << param.Type.TypeName << "\"/>\n";
+        ++index;
+    }
+    os << "            <description>\n";
+    signal.WriteDetailed(os, true, true, 16);
+    os << "\n            </description>\n        </signal>\n";
+}
+
+void ExtractDocVisitor::WriteConstant(llvm::raw_ostream& os, const StringRef& name, const ConstantDoc& constant)
+{
+    os << "        <constant name=\"" << name << "\" value=\""
+       << constant.Value << "\" is_bitfield=\"" << constant.IsBitfield << "\"";
+    if(!constant.Enum.empty())
+    {
+        os << " enum=\"" << constant.Enum << "\"";
+    }
+    constant.WriteAttributes(os);
+    os << ">\n";
+    constant.WriteDetailed(os, true, false, 12);
+    os  << "\n        </constant>\n";
+}
+
+std::error_code ExtractDocVisitor::WriteSection(llvm::raw_ostream& os, const SectionDoc& section)
+{
+    if(section.Error)
+    {
+        return section.Error;
+    }
+    if(!section.SpillPath.empty())
+    {
+        auto spilled = llvm::MemoryBuffer::getFile(section.SpillPath, false, false);
+        if(!spilled)
         {
-            *file << "        <constant name=\"" << constant.first << "\" value=\""
-                  << constant.second.Value << "\" is_bitfield=\"" << constant.second.IsBitfield << "\"";
-            if(!constant.second.Enum.empty())
+            return spilled.getError();
+        }
+        os << (*spilled)->getBuffer();
+    }
+    os << section.Buffer;
+    return std::error_code();
+}
+
+ExtractDocVisitor::SectionDoc::~SectionDoc()
+{
+    if(!SpillPath.empty())
+    {
+        llvm::sys::fs::remove(SpillPath);
+    }
+}
+
+std::error_code ExtractDocVisitor::SectionDoc::SpillBuffer()
+{
+    if(Error)
+    {
+        return Error;
+    }
+    // Closed after each write, so there is no open file for each class
+    int fd;
+    Error = (SpillPath.empty())
+        ? llvm::sys::fs::createTemporaryFile("gdexport-doc", "xml", fd, SpillPath)
+        : llvm::sys::fs::openFileForWrite(SpillPath, fd, llvm::sys::fs::CD_OpenExisting, llvm::sys::fs::OF_Append);
+    if(Error)
+    {
+        return Error;
+    }
+    llvm::raw_fd_ostream os(fd, true);
+    os << Buffer;
+    os.close();
+    if(os.has_error())
+    {
+        Error = os.error();
+        os.clear_error();
+        return Error;
+    }
+    // Swapped, as clearing would keep the memory allocated
+    std::string().swap(Buffer);
+    return std::error_code();
+}
+
+bool ExtractDocVisitor::ClassDoc::Spilled() const
+{
+    return std::any_of(Sections.begin(), Sections.end(), [](const SectionDoc& section)
+        {
+            return !section.SpillPath.empty();
+        });
+}
+
+std::size_t ExtractDocVisitor::BufferedSize(const ClassDoc& cls)
+{
+    std::size_t size = 0;
+    for(const auto& section : cls.Sections)
+    {
+        size += section.Buffer.size();
+    }
+    return size;
+}
+
+void ExtractDocVisitor::StreamEntry(Section section, const StringRef& name,
+    llvm::function_ref<void(llvm::raw_ostream&)> write)
+{
+    auto& doc = current->Sections[section];
+    if(!doc.Names.insert(name).second)
+    {
+        return;
+    }
+    auto size = doc.Buffer.size();
+    {
+        llvm::raw_string_ostream os(doc.Buffer);
+        write(os);
+    }
+    buffered += doc.Buffer.size() - size;
+    Statistics::RecordDocumentationMemory(buffered);
+    if(buffered > *docBudget)
+    {
+        SpillSections();
+    }
+}
+
+void ExtractDocVisitor::SpillSections()
+{
+    auto spill = [this](ClassDoc& cls)
+        {
+            for(auto& section : cls.Sections)
             {
-                *file << " enum=\"" << constant.second.Enum << "\"";
+                auto size = section.Buffer.size();
+                if((buffered <= *docBudget) || (size == 0))
+                {
+                    continue;
+                }
+                // On error the XML is kept in memory (and the error reported when the class is written)
+                if(!section.SpillBuffer())
+                {
+                    buffered -= size;
+                    Statistics::RecordDocumentationMemory(buffered, size);
+                }
             }
-            constant.second.WriteAttributes(*file);
-            *file << ">\n";
-            constant.second.WriteDetailed(*file, true, false, 12);
-            *file  << "\n        </constant>\n";
-        }
-        *file << "    </constants>\n</class>\n";
-        file.reset();
+        };
+    if(current)
+    {
+        spill(*current);
+    }
+    for(auto& cls : pending)
+    {
+        spill(*cls);
     }
 }
 
 void ExtractDocVisitor::ProcessConstant(ConstantType type, const StringRef& name, EnumConstantDecl* declaration)
 {
     ExtractInterfaceVisitor::ProcessConstant(type, name, declaration);
+    if(!current)
+    {
+        return;
+    }
     auto doc = Context().getLocalCommentForDeclUncached(declaration);
     StringRef parentEnum = "";
     if(type != ConstantType::Constants)
@@ -1086,15 +1372,28 @@ void ExtractDocVisitor::ProcessConstant(ConstantType type, const StringRef& name
         parentEnum = enumType->getName();
     }
     auto& traits = Context().getCommentCommandTraits();
-    constants.try_emplace(name, declaration->getValue().getLimitedValue(), type, Class(),
+    if(docBudget)
+    {
+        StreamEntry(ConstantsSection, name, [&](llvm::raw_ostream& os)
+            {
+                WriteConstant(os, name, ConstantDoc(declaration->getValue().getLimitedValue(), type, Class(),
+                    doc, traits, parentEnum));
+            });
+        return;
+    }
+    current->Constants.try_emplace(name, declaration->getValue().getLimitedValue(), type, Class(),
         doc, traits, parentEnum);
 }
 
-void ExtractDocVisitor::ProcessPropertyFunc(const std::string& propertyName, CXXMethodDecl* declaration,
-    const Property& property, const std::string& function, bool isSetter)
+void ExtractDocVisitor::ProcessPropertyFunc(const StringRef& propertyName, CXXMethodDecl* declaration,
+    const Property& property, const StringRef& function, bool isSetter)
 {
     ExtractInterfaceVisitor::ProcessPropertyFunc(propertyName, declaration, property, function, isSetter);
-    auto& propDoc = properties[propertyName];
+    if(!current)
+    {
+        return;
+    }
+    auto& propDoc = current->Properties[propertyName];
     if(!isSetter || !propDoc.Documentation)
     {
         auto doc = Context().getLocalCommentForDeclUncached(declaration);
@@ -1105,31 +1404,54 @@ void ExtractDocVisitor::ProcessPropertyFunc(const std::string& propertyName, CXX
     }
 }
 
-void ExtractDocVisitor::ProcessProperty(const std::string& propertyName, const Property& property)
+void ExtractDocVisitor::ProcessProperty(const StringRef& propertyName, const Property& property)
 {
     ExtractInterfaceVisitor::ProcessProperty(propertyName, property);
-    auto& propDoc = properties[propertyName];
-    propDoc.Property = property;
+    if(current)
+    {
+        auto& propDoc = current->Properties[propertyName];
+        propDoc.Property = property;
+        if(docBudget)
+        {
+            // The property is complete (the getter and setter have been processed)
+            StreamEntry(MembersSection, propertyName, [&](llvm::raw_ostream& os)
+                {
+                    WriteMember(os, propertyName, propDoc);
+                });
+            current->Properties.erase(propertyName);
+        }
+    }
 }
 
-void ExtractDocVisitor::ProcessSignal(const std::string& name, CXXMethodDecl* declaration,
+void ExtractDocVisitor::ProcessSignal(const StringRef& name, CXXMethodDecl* declaration,
         const std::vector<FunctionArgument>& arguments)
 {
     ExtractInterfaceVisitor::ProcessSignal(name, declaration, arguments);
-    auto doc = Context().getLocalCommentForDeclUncached(declaration);
-    auto& traits = Context().getCommentCommandTraits();
-    signals.try_emplace(name, arguments, Class(), doc, traits);
+    if(current)
+    {
+        auto doc = Context().getLocalCommentForDeclUncached(declaration);
+        auto& traits = Context().getCommentCommandTraits();
+        if(docBudget)
+        {
+            StreamEntry(SignalsSection, name, [&](llvm::raw_ostream& os)
+                {
+                    WriteSignal(os, name, FunctionDoc(arguments, Class(), doc, traits));
+                });
+            return;
+        }
+        current->Signals.try_emplace(name, arguments, Class(), doc, traits);
+    }
 }
 
-void ExtractDocVisitor::ProcessMethod(const std::string& name, CXXMethodDecl* declaration, bool isStatic,
+void ExtractDocVisitor::ProcessMethod(const StringRef& name, CXXMethodDecl* declaration, bool isStatic,
     bool isProperty, const std::vector<FunctionArgument>& arguments, const std::optional<GodotType>& returnType)
 {
     ExtractInterfaceVisitor::ProcessMethod(name, declaration, isStatic, isProperty, arguments, returnType);
-    if(!isProperty)
+    if(!isProperty && current)
     {
         auto doc = Context().getLocalCommentForDeclUncached(declaration);
         auto& traits = Context().getCommentCommandTraits();
-        std::string qualifiers;
+        StringRef qualifiers;
         if(isStatic)
         {
             qualifiers = "static";
@@ -1149,6 +1471,14 @@ void ExtractDocVisitor::ProcessMethod(const std::string& name, CXXMethodDecl* de
         {
             qualifiers = "virtual";
         }
-        methods.try_emplace(name, arguments, Class(), doc, traits, returnType, qualifiers);
+        if(docBudget)
+        {
+            StreamEntry(MethodsSection, name, [&](llvm::raw_ostream& os)
+                {
+                    WriteMethod(os, name, MethodDoc(arguments, Class(), doc, traits, returnType, qualifiers));
+                });
+            return;
+        }
+        current->Methods.try_emplace(name, arguments, Class(), doc, traits, returnType, qualifiers);
     }
 }
@@ -7,10 +7,16 @@
 #include "extractinterfacevisitor.hpp"
 #include "utilities.hpp"
 
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/SmallVector.h"
 #include "llvm/Support/raw_ostream.h"
 #include "clang/AST/Comment.h"
 
+#include <array>
 #include <filesystem>
+#include <optional>
+#include <string>
+#include <unordered_set>
 
 /**
  * Specifies the type of a paragraph of text.
@@ -52,6 +58,9 @@ llvm::raw_ostream& operator<<(llvm::raw_ostream& os, ParagraphType type);
 /**
  * Stores information about a paragraph of text in the documentation
  *
+ * The paragraph does not own its text; each span refers either to the text of the comment (owned
+ * by the ASTContext, so valid for the whole translation unit) or to a string literal. This avoids
+ * allocating a string for each piece of text and markup parsed from the comments.
  */
 struct Paragraph
 {
@@ -74,12 +83,19 @@ struct Paragraph
      *
      * @param str
      */
-    void push_front(const std::string& str);
+    void push_front(const StringRef& str);
+
+    /**
+     * Push the specified strings (in order) to the front of the paragraph
+     *
+     * @param strs
+     */
+    void push_front(llvm::ArrayRef<StringRef> strs);
 
     /**
      * Sub-spans of text in the paragraph
      */
-    std::list<std::string> Data;
+    llvm::SmallVector<StringRef, 8> Data;
 
     /**
      * The type of the paragraph
@@ -91,12 +107,10 @@ struct Paragraph
  * Appends text to the paragraph
  *
  * @param para Paragraph to append to
- * @param text Text to append
+ * @param text Text to append (must remain valid for the lifetime of the paragraph)
  * @return The modified paragraph
  */
-Paragraph& operator+=(Paragraph& para, const std::string& text);
 Paragraph& operator+=(Paragraph& para, const StringRef& text);
-Paragraph& operator+=(Paragraph& para, const char* text);
 
 /**
  * Appends an data from another paragraph to the end of the paragraph
@@ -110,7 +124,7 @@ Paragraph& operator+=(Paragraph& para, Paragraph&& text);
 /**
  * List of paragraphs
  */
-typedef std::list<Paragraph> Paragraphs;
+typedef std::vector<Paragraph> Paragraphs;
 
 /**
  * Appends a paragraph to the list of paragraphs
@@ -155,7 +169,7 @@ struct Tutorial
      *
      * @param url The URL of the tutorial
      */
-    Tutorial(const std::string& url) : URL(url), Title() { }
+    Tutorial(const StringRef& url) : URL(url), Title() { }
 
     /**
      * Creates a tutorial with title
@@ -163,12 +177,12 @@ struct Tutorial
      * @param url The URL of the tutorial
      * @param title The title of the tutorial
      */
-    Tutorial(const std::string& url, Paragraph&& title) : URL(url), Title(title) { }
+    Tutorial(const StringRef& url, Paragraph&& title) : URL(url), Title(std::move(title)) { }
 
     /**
      * The URL to the tutorial
      */
-    std::string URL;
+    StringRef URL;
 
     /**
      * The title for the tutorial
@@ -191,7 +205,7 @@ struct Parameters
      *
      * @param desc The description of the argument
      */
-    Parameters(Paragraph&& desc) : Name(), Description(desc) { }
+    Parameters(Paragraph&& desc) : Name(), Description(std::move(desc)) { }
 
     /**
      * Constructs argument documentation with specified description and name
@@ -199,12 +213,12 @@ struct Parameters
      * @param name The name of the argument
      * @param desc The description of the argument
      */
-    Parameters(const std::string& name, Paragraph&& desc) : Name(name), Description(desc) { }
+    Parameters(const StringRef& name, Paragraph&& desc) : Name(name), Description(std::move(desc)) { }
 
     /**
      * The name of the argument
      */
-    std::string Name;
+    StringRef Name;
 
     /**
      * The description of the argument
@@ -344,34 +358,62 @@ public:
      * @param outFile Output stream to write the generated code to
      * @param funcName The name of the function to call to export the classes/methods
      * @param outputFolder Folder to write documentation foles to
+     * @param tables true to register the properties and signals from constant tables
+     * @param thunks true to bind the methods with generated call and ptrcall functions
+     * @param jobs The number of threads to write the documentation files with, once the whole
+     *             translation unit has been traversed; or 0 to write the documentation file for
+     *             each class during the traversal, at the end of each class
+     * @param budget The number of bytes of documentation to hold in memory, when streaming the
+     *               documentation (see docBudget); or empty to keep the parsed documentation of each
+     *               class until the class is written
      */
     ExtractDocVisitor(ASTContext* ctxt, std::unique_ptr<llvm::raw_pwrite_stream>&& outFile,
-        const std::string& funcName, const std::string& outputFolder)
-        : ExtractInterfaceVisitor(ctxt, std::move(outFile), funcName)
+        const std::string& funcName, const std::string& outputFolder, bool tables = false,
+        bool thunks = false, unsigned int jobs = 0, std::optional<std::size_t> budget = std::nullopt)
+        : ExtractInterfaceVisitor(ctxt, std::move(outFile), funcName, tables, thunks)
         , root(outputFolder)
-        , file()
-        , methods()
-        , properties()
-        , signals()
-        , constants()
+        , docJobs(jobs)
+        , docBudget(budget)
+        , buffered(0)
+        , current()
+        , pending()
     {
     }
 
+    /**
+     * Writes the documentation files for the classes which have not been written yet (if writing
+     * with jobs threads), before calling the base method
+     */
+    virtual void EndTranslationUnit() override;
+
 protected:
     virtual void ProcessStartClass(const StringRef& name, CXXRecordDecl* declaration, bool tool) override;
     virtual void ProcessEndClass(const StringRef& name, CXXRecordDecl* declaration) override;
     virtual void ProcessConstant(ConstantType type, const StringRef& name, EnumConstantDecl* declaration) override;
-    virtual void ProcessPropertyFunc(const std::string& propertyName, CXXMethodDecl* declaration,
-        const Property& property, const std::string& function, bool isSetter) override;
-    virtual void ProcessProperty(const std::string& propertyName, const Property& property) override;
-    virtual void ProcessSignal(const std::string& name, CXXMethodDecl* declaration,
+    virtual void ProcessPropertyFunc(const StringRef& propertyName, CXXMethodDecl* declaration,
+        const Property& property, const StringRef& function, bool isSetter) override;
+    virtual void ProcessProperty(const StringRef& propertyName, const Property& property) override;
+    virtual void ProcessSignal(const StringRef& name, CXXMethodDecl* declaration,
         const std::vector<FunctionArgument>& arguments) override;
-    virtual void ProcessMethod(const std::string& name, CXXMethodDecl* declaration, bool isStatic, bool isProperty,
+    virtual void ProcessMethod(const StringRef& name, CXXMethodDecl* declaration, bool isStatic, bool isProperty,
         const std::vector<FunctionArgument>& arguments, const std::optional<GodotType>& returnType) override;
 
 private:
     std::filesystem::path root;
-    std::unique_ptr<llvm::raw_fd_stream> file;
+    unsigned int docJobs;
+
+    /**
+     * The number of bytes of documentation to hold in memory, if streaming the documentation; i.e.,
+     * rendering the XML of each method, member, signal and constant as it is parsed (rather than
+     * keeping the parsed documentation until the end of the class), and moving the rendered XML
+     * of the classes to temporary files once more than the budget is held in memory
+     */
+    std::optional<std::size_t> docBudget;
+
+    /**
+     * The number of bytes of rendered XML held in memory (when streaming the documentation)
+     */
+    std::size_t buffered;
 
     /**
      * Parsed documentation for a constant
@@ -422,7 +464,7 @@ private:
     struct MethodDoc : public FunctionDoc
     {
         MethodDoc(const std::vector<FunctionArgument>& args, const StringRef& className, comments::FullComment* doc,
-                const comments::CommandTraits& traits, const  std::optional<GodotType>& returnType, const std::string& qualifiers)
+                const comments::CommandTraits& traits, const  std::optional<GodotType>& returnType, const StringRef& qualifiers)
             : FunctionDoc(args, className, doc, traits)
             , ReturnType(returnType)
             , Qualifiers(qualifiers)
@@ -430,13 +472,204 @@ private:
         }
 
         std::optional<GodotType> ReturnType;
-        std::string Qualifiers;
+        StringRef Qualifiers;
+    };
+
+    /**
+     * The sections of the documentation of a class, in the order written
+     */
+    enum Section : std::size_t
+    {
+        MethodsSection,
+        MembersSection,
+        SignalsSection,
+        ConstantsSection,
+        SectionCount
+    };
+
+    /**
+     * The rendered XML of the entries of a section of a class, when streaming the documentation:
+     * held in memory, and appended to a temporary file when the budget is exceeded
+     */
+    struct SectionDoc
+    {
+        SectionDoc() : Buffer(), Names(), SpillPath(), Error() { }
+
+        SectionDoc(const SectionDoc&) = delete;
+        SectionDoc& operator=(const SectionDoc&) = delete;
+
+        /**
+         * Removes the temporary file
+         */
+        ~SectionDoc();
+
+        /**
+         * Append the buffered XML to the temporary file (creating the file on the first call),
+         * releasing the buffer. On error the buffer is kept, and the error is reported when the
+         * documentation file is written (as the temporary file may be incomplete)
+         *
+         * @return The error creating or writing the file (or success)
+         */
+        std::error_code SpillBuffer();
+
+        std::string Buffer;
+        std::unordered_set<StringRef> Names;
+        llvm::SmallString<128> SpillPath;
+        std::error_code Error;
+    };
+
+    /**
+     * Parsed documentation for a class and its members; i.e., everything needed to write the
+     * documentation file for the class without accessing the AST
+     */
+    struct ClassDoc
+    {
+        ClassDoc(const StringRef& name, const std::string& path, const SourceLocation& location,
+                comments::FullComment* doc, const comments::CommandTraits& traits)
+            : Name(name)
+            , Path(path)
+            , Location(location)
+            , Inherits()
+            , Documentation(name, doc, traits)
+            , Methods()
+            , Properties()
+            , Signals()
+            , Constants()
+            , Sections()
+        {
+        }
+
+        /**
+         * Gets if any of the rendered XML of the class has been moved to temporary files
+         *
+         * @return true if any section has a temporary file; false otherwise
+         */
+        bool Spilled() const;
+
+        StringRef Name;
+        std::string Path;
+        SourceLocation Location;
+        std::vector<StringRef> Inherits;
+        ParsedDocumentation Documentation;
+        std::unordered_map<StringRef, MethodDoc> Methods;
+        std::unordered_map<StringRef, PropertyDoc> Properties;
+        std::unordered_map<StringRef, FunctionDoc> Signals;
+        std::unordered_map<StringRef, ConstantDoc> Constants;
+
+        /**
+         * The rendered XML of the sections, when streaming the documentation (in which case the
+         * maps above are empty, except for the properties of the current group)
+         */
+        std::array<SectionDoc, SectionCount> Sections;
     };
 
-    std::unordered_map<std::string, MethodDoc> methods;
-    std::unordered_map<std::string, PropertyDoc> properties;
-    std::unordered_map<std::string, FunctionDoc> signals;
-    std::unordered_map<StringRef, ConstantDoc> constants;
+    /**
+     * Write the XML documentation for a method of a class
+     *
+     * @param os The stream to write to
+     * @param name The name of the method
+     * @param method The documentation for the method
+     */
+    static void WriteMethod(llvm::raw_ostream& os, const StringRef& name, const MethodDoc& method);
+
+    /**
+     * Write the XML documentation for a member (property) of a class
+     *
+     * @param os The stream to write to
+     * @param name The name of the property
+     * @param property The documentation for the property
+     */
+    static void WriteMember(llvm::raw_ostream& os, const StringRef& name, const PropertyDoc& property);
+
+    /**
+     * Write the XML documentation for a signal of a class
+     *
+     * @param os The stream to write to
+     * @param name The name of the signal
+     * @param signal The documentation for the signal
+     */
+    static void WriteSignal(llvm::raw_ostream& os, const StringRef& name, const FunctionDoc& signal);
+
+    /**
+     * Write the XML documentation for a constant of a class
+     *
+     * @param os The stream to write to
+     * @param name The name of the constant
+     * @param constant The documentation for the constant
+     */
+    static void WriteConstant(llvm::raw_ostream& os, const StringRef& name, const ConstantDoc& constant);
+
+    /**
+     * Render the XML of an entry of the current class into the buffer of its section (when
+     * streaming the documentation), unless an entry with the same name has already been added
+     * (as only the first is kept, the same as the maps of the ClassDoc)
+     *
+     * @param section The section of the entry
+     * @param name The name of the entry
+     * @param write Function writing the XML of the entry
+     */
+    void StreamEntry(Section section, const StringRef& name, llvm::function_ref<void(llvm::raw_ostream&)> write);
+
+    /**
+     * Move the rendered XML of the current class, and then of the classes pending, to temporary
+     * files, until no more than the budget is held in memory
+     */
+    void SpillSections();
+
+    /**
+     * Gets the number of bytes of rendered XML of a class held in memory
+     *
+     * @param cls The documentation for the class
+     * @return The number of bytes
+     */
+    static std::size_t BufferedSize(const ClassDoc& cls);
+
+    /**
+     * Write the XML documentation for a class
+     *
+     * @param os The stream to write to
+     * @param cls The documentation for the class
+     * @return The error reading the XML moved to temporary files (or success)
+     */
+    static std::error_code WriteClass(llvm::raw_ostream& os, const ClassDoc& cls);
+
+    /**
+     * Write the rendered XML of a section of a class (from the temporary file, followed by the
+     * XML held in memory), when streaming the documentation
+     *
+     * @param os The stream to write to
+     * @param section The rendered section
+     * @return The error reading the temporary file (or success)
+     */
+    static std::error_code WriteSection(llvm::raw_ostream& os, const SectionDoc& section);
+
+    /**
+     * Write the XML documentation file for a class, if the content has changed (see
+     * WriteFileIfChanged), so an incomplete file is never left in place. Safe to call from any thread.
+     *
+     * @param cls The documentation for the class
+     * @return The error writing the file (or no error on success)
+     */
+    static std::error_code WriteClassFile(const ClassDoc& cls);
+
+    /**
+     * Report an error writing the XML documentation file for a class
+     *
+     * @param cls The documentation for the class
+     * @param err The error
+     */
+    void ReportWriteError(const ClassDoc& cls, const std::error_code& err);
+
+    /**
+     * The documentation for the current class (or null if not in a class, or when the
+     * documentation for the class is not being generated)
+     */
+    std::unique_ptr<ClassDoc> current;
+
+    /**
+     * The documentation for classes to write once the translation unit has been traversed
+     */
+    std::vector<std::unique_ptr<ClassDoc>> pending;
 };
 
 #endif // GDEXPORT_EXTRACTDOCVISITOR_HPP
@@ -2,11 +2,16 @@
 // SPDX-License-Identifier: Zlib
 
 #include "extractinterfacevisitor.hpp"
+#include "interfacesink.hpp"
 
+#include "statistics.hpp"
 #include "utilities.hpp"
 
 #include "clang/AST/ASTContext.h"
+#include "clang/AST/QualTypeNames.h"
 #include "clang/Basic/SourceManager.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/xxhash.h"
 
 // #include <godot_cpp/variant/variant.hpp>
 // #include <godot_cpp/classes/global_constants.hpp>
@@ -31,12 +36,343 @@ std::string Join(It begin, It end)
 // TODO: Check if method/properties/signals are inside an exported class
 using namespace clang;
 
+/**
+ * Types and functions written to the generated code (before the first class) when writing the
+ * properties and signals as tables. Guarded, so generated files can be included in a single
+ * (jumbo) translation unit
+ */
+static const char TableSupport[] = R"(#ifndef GDEXPORT_TABLE_SUPPORT
+#define GDEXPORT_TABLE_SUPPORT
+namespace
+{
+    typedef const ::godot::StringName& (*GDExportNameFunction)(std::size_t);
+
+    enum class GDExportPropertyKind
+    {
+        Property,
+        Group,
+        Subgroup
+    };
+
+    struct GDExportProperty
+    {
+        GDExportPropertyKind Kind;
+        ::godot::Variant::Type Type;
+        std::size_t Name;
+        uint32_t Hint;
+        const char* HintString;
+        uint32_t Usage;
+        std::size_t Setter;
+        std::size_t Getter;
+    };
+
+    struct GDExportSignalArgument
+    {
+        ::godot::Variant::Type Type;
+        std::size_t Name;
+    };
+
+    struct GDExportSignal
+    {
+        std::size_t Name;
+        const GDExportSignalArgument* Arguments;
+        uint32_t ArgumentCount;
+    };
+
+    inline void GDExportAddProperties(const ::godot::StringName& cls, GDExportNameFunction name,
+        const GDExportProperty* properties, std::size_t count)
+    {
+        for(std::size_t i = 0; i < count; ++i)
+        {
+            const auto& property = properties[i];
+            switch(property.Kind)
+            {
+            case GDExportPropertyKind::Group:
+                ::godot::ClassDB::add_property_group(cls, name(property.Name), property.HintString);
+                break;
+            case GDExportPropertyKind::Subgroup:
+                ::godot::ClassDB::add_property_subgroup(cls, name(property.Name), property.HintString);
+                break;
+            default:
+                ::godot::ClassDB::add_property(cls, ::godot::PropertyInfo(property.Type,
+                    name(property.Name), static_cast<::godot::PropertyHint>(property.Hint),
+                    property.HintString, property.Usage),
+                    name(property.Setter), name(property.Getter));
+                break;
+            }
+        }
+    }
+
+    inline void GDExportAddSignals(const ::godot::StringName& cls, GDExportNameFunction name,
+        const GDExportSignal* signals, std::size_t count)
+    {
+        for(std::size_t i = 0; i < count; ++i)
+        {
+            ::godot::MethodInfo info;
+            info.name = name(signals[i].Name);
+            for(uint32_t arg = 0; arg < signals[i].ArgumentCount; ++arg)
+            {
+                info.arguments.push_back(::godot::PropertyInfo(signals[i].Arguments[arg].Type,
+                    name(signals[i].Arguments[arg].Name)));
+            }
+            ::godot::ClassDB::add_signal(cls, info);
+        }
+    }
+}
+#endif // GDEXPORT_TABLE_SUPPORT
+
+)";
+
+/**
+ * Functions written to the generated code (before the first class) when binding the methods with
+ * generated call and ptrcall functions. Guarded, so generated files can be included in a single
+ * (jumbo) translation unit.
+ *
+ * The functions used by the call and ptrcall functions of each signature (see
+ * ExtractInterfaceVisitor::SignatureThunks) are inline functions in the `gdexport` namespace (rather
+ * than an anonymous namespace), so the linker keeps a single copy across translation units
+ */
+static const char ThunkSupport[] = R"(#ifndef GDEXPORT_THUNK_SUPPORT
+#define GDEXPORT_THUNK_SUPPORT
+namespace gdexport
+{
+    typedef void (*GDExportFunction)();
+
+    // The userdata of a method bound with the call and ptrcall functions of its signature
+    struct GDExportMethod
+    {
+        GDExportFunction Function;
+        const ::godot::Variant* Defaults;
+        GDExtensionInt FirstDefault;
+    };
+
+    inline bool GDExportCheckCall(const GDExtensionConstVariantPtr* args, GDExtensionInt count,
+        const GDExtensionVariantType* types, GDExtensionInt total, GDExtensionInt required,
+        GDExtensionCallError* error)
+    {
+        if(count < required)
+        {
+            error->error = GDEXTENSION_CALL_ERROR_TOO_FEW_ARGUMENTS;
+            error->expected = static_cast<int32_t>(required);
+            return false;
+        }
+        if(count > total)
+        {
+            error->error = GDEXTENSION_CALL_ERROR_TOO_MANY_ARGUMENTS;
+            error->expected = static_cast<int32_t>(total);
+            return false;
+        }
+        for(GDExtensionInt i = 0; i < count; ++i)
+        {
+            auto expected = static_cast<::godot::Variant::Type>(types[i]);
+            auto type = reinterpret_cast<const ::godot::Variant*>(args[i])->get_type();
+            if((expected != ::godot::Variant::NIL) && (type != expected)
+                && !::godot::Variant::can_convert_strict(type, expected))
+            {
+                error->error = GDEXTENSION_CALL_ERROR_INVALID_ARGUMENT;
+                error->argument = static_cast<int32_t>(i);
+                error->expected = static_cast<int32_t>(expected);
+                return false;
+            }
+        }
+        error->error = GDEXTENSION_CALL_OK;
+        return true;
+    }
+
+    inline const ::godot::Variant& GDExportArgument(const GDExtensionConstVariantPtr* args,
+        GDExtensionInt count, GDExtensionInt index, const GDExportMethod* method)
+    {
+        return (index < count)
+            ? *reinterpret_cast<const ::godot::Variant*>(args[index])
+            : method->Defaults[index - method->FirstDefault];
+    }
+}
+
+namespace
+{
+    inline ::godot::PropertyInfo GDExportNamedInfo(::godot::PropertyInfo info, const ::godot::StringName& name)
+    {
+        info.name = name;
+        return info;
+    }
+
+    inline GDExtensionPropertyInfo GDExportPropertyInfo(const ::godot::PropertyInfo& info)
+    {
+        return GDExtensionPropertyInfo{static_cast<GDExtensionVariantType>(info.type),
+            info.name._native_ptr(), info.class_name._native_ptr(), info.hint,
+            info.hint_string._native_ptr(), info.usage};
+    }
+
+    inline void GDExportBindMethod(const ::godot::StringName& cls, const ::godot::StringName& name, uint32_t flags,
+        const ::gdexport::GDExportMethod* method, GDExtensionClassMethodCall call, GDExtensionClassMethodPtrCall ptrcall,
+        const ::godot::PropertyInfo* returnInfo, GDExtensionClassMethodArgumentMetadata returnMetadata,
+        const ::godot::PropertyInfo* arguments, const GDExtensionClassMethodArgumentMetadata* metadata,
+        uint32_t argumentCount, const ::godot::Variant* defaults, uint32_t defaultCount)
+    {
+        GDExtensionPropertyInfo returnValue{};
+        if(returnInfo)
+        {
+            returnValue = GDExportPropertyInfo(*returnInfo);
+        }
+        std::vector<GDExtensionPropertyInfo> argumentInfo;
+        argumentInfo.reserve(argumentCount);
+        for(uint32_t i = 0; i < argumentCount; ++i)
+        {
+            argumentInfo.push_back(GDExportPropertyInfo(arguments[i]));
+        }
+        std::vector<GDExtensionVariantPtr> defaultValues;
+        defaultValues.reserve(defaultCount);
+        for(uint32_t i = 0; i < defaultCount; ++i)
+        {
+            defaultValues.push_back(defaults[i]._native_ptr());
+        }
+        GDExtensionClassMethodInfo info{
+            name._native_ptr(),
+            const_cast<::gdexport::GDExportMethod*>(method),
+            call,
+            ptrcall,
+            flags,
+            returnInfo != nullptr,
+            (returnInfo) ? &returnValue : nullptr,
+            returnMetadata,
+            argumentCount,
+            argumentInfo.data(),
+            const_cast<GDExtensionClassMethodArgumentMetadata*>(metadata),
+            defaultCount,
+            defaultValues.data()
+        };
+        ::godot::internal::gdextension_interface_classdb_register_extension_class_method(
+            ::godot::internal::library, cls._native_ptr(), &info);
+    }
+}
+#endif // GDEXPORT_THUNK_SUPPORT
+
+)";
+
+/**
+ * Checks if a declaration can be named outside the class it is declared in; i.e., it, and each
+ * class it is nested in, is public
+ *
+ * @param declaration The declaration
+ * @return true if the declaration is not a member of a class, or is a public member in public classes
+ */
+static bool IsPublicDeclaration(const Decl* declaration)
+{
+    while(const auto* record = dyn_cast<CXXRecordDecl>(declaration->getDeclContext()))
+    {
+        if(declaration->getAccess() != AS_public)
+        {
+            return false;
+        }
+        declaration = record;
+    }
+    return true;
+}
+
+/**
+ * Finds a type which can not be named at namespace scope (a private or protected nested class,
+ * enum or typedef) in a type, or in its template arguments
+ *
+ * @param type The type
+ * @return The declaration of the type which can not be named; or nullptr if there is none
+ */
+static const NamedDecl* FindNonPublicType(QualType type)
+{
+    type = type.getNonReferenceType();
+    while(true)
+    {
+        if(const auto* typedefType = type->getAs<TypedefType>())
+        {
+            if(!IsPublicDeclaration(typedefType->getDecl()))
+            {
+                return typedefType->getDecl();
+            }
+            type = typedefType->desugar();
+        }
+        else if(type->isPointerType())
+        {
+            type = type->getPointeeType();
+        }
+        else
+        {
+            break;
+        }
+    }
+    const TagDecl* tag = type.getCanonicalType()->getAsTagDecl();
+    if(!tag)
+    {
+        return nullptr;
+    }
+    if(!IsPublicDeclaration(tag))
+    {
+        return tag;
+    }
+    if(const auto* templates = dyn_cast<ClassTemplateSpecializationDecl>(tag))
+    {
+        const auto& targs = templates->getTemplateArgs();
+        for(unsigned int i = 0; i < targs.size(); ++i)
+        {
+            if(targs[i].getKind() == TemplateArgument::ArgKind::Type)
+            {
+                if(const NamedDecl* found = FindNonPublicType(targs[i].getAsType()))
+                {
+                    return found;
+                }
+            }
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * Checks if the return and argument types of a method can all be named at namespace scope, so the
+ * method can be bound with the call and ptrcall functions of its signature (which are in the
+ * `gdexport` namespace)
+ *
+ * @param declaration The declaration of the method
+ * @return true if there are no private or protected types in the signature of the method
+ */
+static bool HasPublicSignature(const CXXMethodDecl* declaration)
+{
+    if(FindNonPublicType(declaration->getReturnType()))
+    {
+        return false;
+    }
+    for(const auto* param : declaration->parameters())
+    {
+        if(FindNonPublicType(param->getType()))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
 ExtractInterfaceVisitor::ExtractInterfaceVisitor(ASTContext* ctxt,
-    std::unique_ptr<llvm::raw_pwrite_stream>&& outFile, const std::string& func)
+    std::unique_ptr<llvm::raw_pwrite_stream>&& outFile, const std::string& func, bool useTables,
+    bool useThunks)
     : context(ctxt)
     , classes()
+    , sinks()
+    , allocator()
+    , strings(allocator)
+    , typeCache()
     , properties()
-    , signals()
+    , signalBuffer()
+    , signals(signalBuffer)
+    , tables(useTables)
+    , propertyTable()
+    , signalTable()
+    , signalArguments()
+    , signalArgumentCount(0)
+    , thunks(useThunks)
+    , signatureBuffer()
+    , signatureThunks(signatureBuffer)
+    , signatureNames()
+    , bodyBuffer()
+    , body(bodyBuffer)
+    , nameIndices()
+    , names()
     , currentNamespace()
     , writtenNS(0)
     , currentClass("")
@@ -44,20 +380,62 @@ ExtractInterfaceVisitor::ExtractInterfaceVisitor(ASTContext* ctxt,
     , inEnum(ConstantType::None)
     , output(std::move(outFile))
     , funcName(func)
+    , nameFunction("GDExportName_" + func)
 {
 }
 
 ExtractInterfaceVisitor::~ExtractInterfaceVisitor()
 {
-    if(!classes.empty())
+    if(!names.empty())
     {
-        outs() << "// Export: initialize_" << funcName << " ====================\n"
-            "void initialize_" << funcName << "()\n{\n";
-        for(const auto& cls : classes)
+        // Constructed on the first call, as the StringNames can only be created once godot has
+        // initialized the extension
+        outs() << "namespace\n{\n"
+            << "    const ::godot::StringName& " << nameFunction << "(std::size_t index)\n    {\n"
+            "        static const ::godot::StringName names[] = {\n";
+        for(const auto& name : names)
         {
-            outs() << "    GDREGISTER" << ((cls.second) ? "" : "_RUNTIME") << "_CLASS(" << cls.first << ");\n";
+            outs() << "            \"" << name << "\",\n";
         }
-        outs() << "}\n";
+        outs() << "        };\n        return names[index];\n    }\n}\n\n";
+    }
+    // Each class is registered by its own function, so the entry point can register the classes
+    // of every header in order of inheritance, and at different initialization levels
+    for(const auto& cls : classes)
+    {
+        outs() << "// Export: register_" << funcName << '_' << cls.Name << " ====================\n"
+            "void register_" << funcName << '_' << cls.Name << "()\n{\n"
+            "    GDREGISTER" << ((cls.Tool) ? "" : "_RUNTIME") << "_CLASS(" << cls.QualifiedName << ");\n"
+            "}\n\n";
+    }
+    // Always defined, as the entry point calls the function for every header when it has no
+    // registration plan
+    outs() << "// Export: initialize_" << funcName << " ====================\n"
+        "void initialize_" << funcName << "()\n{\n";
+    for(const auto& cls : classes)
+    {
+        outs() << "    register_" << funcName << '_' << cls.Name << "();\n";
+    }
+    outs() << "}\n";
+    if(thunks)
+    {
+        // The call and ptrcall functions of the signatures are only known once every class is
+        // written, but must be defined before the first class
+        auto& os = (output) ? *output : llvm::outs();
+        os << signatureBuffer << bodyBuffer;
+    }
+}
+
+void ExtractInterfaceVisitor::AddSink(std::unique_ptr<InterfaceSink>&& sink)
+{
+    sinks.push_back(std::move(sink));
+}
+
+void ExtractInterfaceVisitor::EndTranslationUnit()
+{
+    for(auto& sink : sinks)
+    {
+        sink->EndTranslationUnit(*context);
     }
 }
 
@@ -84,8 +462,9 @@ bool ExtractInterfaceVisitor::TraverseCXXRecordDecl(CXXRecordDecl* declaration)
         bool popClass = false;
         for(const auto& attr : declaration->specific_attrs<AnnotateAttr>())
         {
-            bool tool = (attr->getAnnotation() == "godot::tool");
-            if(tool || (attr->getAnnotation() == "godot::class"))
+            auto kind = ClassifyAttribute(attr);
+            bool tool = (kind == GodotAttribute::Tool);
+            if(tool || (kind == GodotAttribute::Class))
             {
                 if(currentClass.empty())
                 {
@@ -93,6 +472,10 @@ bool ExtractInterfaceVisitor::TraverseCXXRecordDecl(CXXRecordDecl* declaration)
                     inClass = true;
                     popClass = true;
                     ProcessStartClass(declaration->getName(), declaration, tool);
+                    for(auto& sink : sinks)
+                    {
+                        sink->ProcessStartClass(classes.back(), declaration);
+                    }
                 }
                 break;
             }
@@ -101,6 +484,10 @@ bool ExtractInterfaceVisitor::TraverseCXXRecordDecl(CXXRecordDecl* declaration)
         if(popClass)
         {
             ProcessEndClass(declaration->getName(), declaration);
+            for(auto& sink : sinks)
+            {
+                sink->ProcessEndClass(classes.back(), declaration);
+            }
             inClass = false;
             currentClass = "";
         }
@@ -115,22 +502,21 @@ bool ExtractInterfaceVisitor::TraverseEnumDecl(EnumDecl* declaration)
     {
         for(const auto& attr : declaration->specific_attrs<AnnotateAttr>())
         {
-            auto annotation = attr->getAnnotation();
-            if(annotation == "godot::enum")
+            switch(ClassifyAttribute(attr))
             {
+            case GodotAttribute::Enum:
                 inEnum = ConstantType::Enum;
                 break;
-            }
-            else if(annotation == "godot::bitfield")
-            {
+            case GodotAttribute::Bitfield:
                 inEnum = ConstantType::Bitfield;
                 break;
-            }
-            else if(annotation == "godot::constants")
-            {
+            case GodotAttribute::Constants:
                 inEnum = ConstantType::Constants;
                 break;
+            default:
+                continue;
             }
+            break;
         }
         auto result = RecursiveASTVisitor<ExtractInterfaceVisitor>::TraverseEnumDecl(declaration);
         inEnum = ConstantType::None;
@@ -144,6 +530,10 @@ bool ExtractInterfaceVisitor::VisitEnumConstantDecl(EnumConstantDecl* declaratio
     if(inEnum != ConstantType::None)
     {
         ProcessConstant(inEnum, declaration->getName(), declaration);
+        for(auto& sink : sinks)
+        {
+            sink->ProcessConstant(inEnum, declaration->getName(), declaration);
+        }
     }
     return true;
 }
@@ -154,8 +544,13 @@ bool ExtractInterfaceVisitor::VisitCXXMethodDecl(CXXMethodDecl* declaration)
     {
         for(const auto& attr : declaration->specific_attrs<AnnotateAttr>())
         {
+            auto kind = ClassifyAttribute(attr);
+            if(kind == GodotAttribute::None)
+            {
+                continue;
+            }
             auto nameInfo = declaration->getDeclName();
-            std::string name;
+            StringRef name;
             auto annotation = attr->getAnnotation();
             switch(nameInfo.getNameKind())
             {
@@ -172,21 +567,25 @@ bool ExtractInterfaceVisitor::VisitCXXMethodDecl(CXXMethodDecl* declaration)
                         "%0 is not attached to a function", annotation);
                     return false;
             }
-            if((annotation == "godot::group") || (annotation == "godot::subgroup"))
+            if((kind == GodotAttribute::Group) || (kind == GodotAttribute::Subgroup))
             {
                 bool parsed = false;
                 auto it = attr->args_begin();
                 auto end = attr->args_end();
-                std::string groupName = ParseString(it, end, "", parsed);
+                StringRef groupName = ParseString(it, end, "", parsed);
                 if(!parsed || groupName.empty())
                 {
                     GenerateError(*context, attr->getLocation(), DiagnosticsEngine::Error,
                         "%0 does not have a group name", annotation);
                 }
-                std::string prefix = ParseString(it, end, "", parsed);
-                ProcessGroup(groupName, prefix, annotation == "godot::subgroup");
+                StringRef prefix = ParseString(it, end, "", parsed);
+                ProcessGroup(groupName, prefix, kind == GodotAttribute::Subgroup);
+                for(auto& sink : sinks)
+                {
+                    sink->ProcessGroup(groupName, prefix, kind == GodotAttribute::Subgroup);
+                }
             }
-            else if(annotation == "godot::signal")
+            else if(kind == GodotAttribute::Signal)
             {
                 auto loc = declaration->getLocation();
                 std::vector<FunctionArgument> args;
@@ -194,26 +593,30 @@ bool ExtractInterfaceVisitor::VisitCXXMethodDecl(CXXMethodDecl* declaration)
                 auto end = declaration->param_end();
                 for(auto it = declaration->param_begin(); it != end; ++it)
                 {
-                    auto paramName = (*it)->getQualifiedNameAsString();
+                    StringRef paramName = (*it)->getName();
                     if(paramName.empty())
                     {
                         GenerateError(*context, loc, DiagnosticsEngine::Warning,
                             "Signal '%0' has an argument with no name; generated code may be invalid", name);
-                        paramName = "arg" + std::to_string(args.size());
+                        paramName = strings.save("arg" + Twine(args.size()));
                     }
-                    args.emplace_back(paramName, (*it)->getType(), GetRawSource(*context, *it));
+                    args.emplace_back(paramName, typeCache.Get((*it)->getType()), GetRawSource(*context, *it));
                 }
                 ProcessSignal(name, declaration, args);
+                for(auto& sink : sinks)
+                {
+                    sink->ProcessSignal(name, declaration, args);
+                }
             }
             else
             {
                 Property* property = nullptr;
-                if(annotation == "godot::getter")
+                if(kind == GodotAttribute::Getter)
                 {
                     auto it = attr->args_begin();
                     auto end = attr->args_end();
                     bool parsed = false;
-                    std::string propertyName = ParseString(it, end, name, parsed);
+                    StringRef propertyName = ParseString(it, end, name, parsed);
                     if(!parsed)
                     {
                         GenerateError(*context, declaration->getLocation(), DiagnosticsEngine::Warning,
@@ -223,7 +626,7 @@ bool ExtractInterfaceVisitor::VisitCXXMethodDecl(CXXMethodDecl* declaration)
                     property->Getter = name;
                     property->GetterLoc = declaration->getLocation();
                     auto type = ParseEnum(*context, it, end, "", "property type", propertyName);
-                    property->Type.Parse(declaration->getReturnType(), type);
+                    property->Type = typeCache.Get(declaration->getReturnType(), type);
                     property->Usage = ParseBitfield(*context, it, end, "::godot::PROPERTY_USAGE_DEFAULT",
                         "property usage", propertyName);
 
@@ -239,12 +642,12 @@ bool ExtractInterfaceVisitor::VisitCXXMethodDecl(CXXMethodDecl* declaration)
                     }
                     ProcessPropertyFunc(propertyName, declaration, *property, name, false);
                 }
-                else if(annotation == "godot::setter")
+                else if(kind == GodotAttribute::Setter)
                 {
                     auto it = attr->args_begin();
                     auto end = attr->args_end();
                     bool found = false;
-                    std::string propertyName = ParseString(it, end, name, found);
+                    StringRef propertyName = ParseString(it, end, name, found);
                     if(!found)
                     {
                         GenerateError(*context, declaration->getLocation(), DiagnosticsEngine::Warning,
@@ -269,7 +672,7 @@ bool ExtractInterfaceVisitor::VisitCXXMethodDecl(CXXMethodDecl* declaration)
                     }
                     ProcessPropertyFunc(propertyName, declaration, *property, name, true);
                 }
-                else if(annotation == "godot::method")
+                else if(kind == GodotAttribute::Method)
                 {
                     ProcessMethod(name, declaration, declaration->isStatic());
                 }
@@ -279,9 +682,9 @@ bool ExtractInterfaceVisitor::VisitCXXMethodDecl(CXXMethodDecl* declaration)
     return true;
 }
 
-void ExtractInterfaceVisitor::ProcessStartClass(const StringRef& className, CXXRecordDecl*, bool tool)
+void ExtractInterfaceVisitor::ProcessStartClass(const StringRef& className, CXXRecordDecl* declaration, bool tool)
 {
-    llvm::outs() << className.str() << "\n";
+    PhaseScope scope(Phase::Emission, "ExtractInterfaceVisitor::Emit");
     std::ostringstream fullyQualified;
     if(!currentNamespace.empty())
     {
@@ -292,7 +695,37 @@ void ExtractInterfaceVisitor::ProcessStartClass(const StringRef& className, CXXR
         fullyQualified << "::";
     }
     fullyQualified << className.str();
-    classes.emplace_back(fullyQualified.str(), tool);
+    // As for the documentation, the first base class is assumed to be the class inherited from
+    // in godot. Qualified as for the exported classes (only prefixed with `::` when declared in a
+    // namespace), so the base can be matched to the exported class
+    std::string base;
+    for(const auto& baseSpecifier : declaration->bases())
+    {
+        auto cls = GetUnderlyingType(baseSpecifier.getType())->getAsCXXRecordDecl();
+        if(cls)
+        {
+            base = cls->getQualifiedNameAsString();
+            if(!cls->getDeclContext()->getEnclosingNamespaceContext()->isTranslationUnit())
+            {
+                base = "::" + base;
+            }
+            break;
+        }
+    }
+    classes.push_back(ExportedClass{className.str(), fullyQualified.str(), tool, std::move(base)});
+    if(classes.size() == 1)
+    {
+        // Named for the header, so generated files can be included in a single (jumbo) translation unit
+        outs() << "namespace\n{\n    const ::godot::StringName& " << nameFunction << "(std::size_t index);\n}\n\n";
+    }
+    if(tables && (classes.size() == 1))
+    {
+        outs() << TableSupport;
+    }
+    if(thunks && (classes.size() == 1))
+    {
+        signatureThunks << ThunkSupport;
+    }
     for(; writtenNS < currentNamespace.size(); ++writtenNS)
     {
         Indent() << "namespace " << currentNamespace[writtenNS] << '\n';
@@ -304,15 +737,28 @@ void ExtractInterfaceVisitor::ProcessStartClass(const StringRef& className, CXXR
 
 void ExtractInterfaceVisitor::ProcessEndClass(const StringRef& name, CXXRecordDecl* declaration)
 {
+    PhaseScope scope(Phase::Emission, "ExtractInterfaceVisitor::Emit");
     WriteProperties();
+    if(tables)
+    {
+        WriteTables();
+    }
     Indent() << "}\n";
     WriteSignals();
 }
 
-void ExtractInterfaceVisitor::ProcessGroup(const std::string& name, const std::string& prefix, bool subgroup)
+void ExtractInterfaceVisitor::ProcessGroup(const StringRef& name, const StringRef& prefix, bool subgroup)
 {
+    PhaseScope scope(Phase::Emission, "ExtractInterfaceVisitor::Emit");
     WriteProperties();
 
+    if(tables)
+    {
+        llvm::raw_svector_ostream row(propertyTable);
+        row.indent(4*(writtenNS + 2)) << "{GDExportPropertyKind::" << ((subgroup) ? "Subgroup" : "Group")
+            << ", ::godot::Variant::NIL, " << NameIndex(name) << ", 0, \"" << prefix << "\", 0, 0, 0},\n";
+        return;
+    }
     outs() << '\n';
     IndentFunc() << "ADD_";
     if(subgroup)
@@ -322,54 +768,98 @@ void ExtractInterfaceVisitor::ProcessGroup(const std::string& name, const std::s
     outs() << "GROUP(\"" << name << "\", \"" << prefix << "\");\n";
 }
 
-void ExtractInterfaceVisitor::ProcessSignal(const std::string& name, CXXMethodDecl* declaration,
+void ExtractInterfaceVisitor::ProcessSignal(const StringRef& name, CXXMethodDecl* declaration,
         const std::vector<FunctionArgument>& arguments)
 {
-    auto& signal = signals.emplace_back(name, declaration->getLocation());
-    IndentFunc() << "ADD_SIGNAL(::godot::MethodInfo(\"" << name << '\"';
-    signal.ArgNames.reserve(arguments.size());
-
-    for(const auto& param : arguments)
+    PhaseScope scope(Phase::Emission, "ExtractInterfaceVisitor::Emit");
+    if(tables)
+    {
+        llvm::raw_svector_ostream row(signalTable);
+        row.indent(4*(writtenNS + 2)) << "{" << NameIndex(name) << ", ";
+        if(arguments.empty())
+        {
+            row << "nullptr";
+        }
+        else
+        {
+            row << "gdexport_signal_arguments + " << signalArgumentCount;
+        }
+        row << ", " << arguments.size() << "},\n";
+        llvm::raw_svector_ostream args(signalArguments);
+        for(const auto& param : arguments)
+        {
+            args.indent(4*(writtenNS + 2)) << "{" << param.Type.VariantType << ", " << NameIndex(param.Name) << "},\n";
+        }
+        signalArgumentCount += arguments.size();
+    }
+    else
     {
-        outs() << ", ::godot::PropertyInfo(" << param.Type.VariantType << ", \"" << param.Name << "\")";
-        if(!signal.Signature.empty())
+        IndentFunc() << "ADD_SIGNAL(::godot::MethodInfo(" << nameFunction << "(" << NameIndex(name) << ")";
+        for(const auto& param : arguments)
         {
-            signal.Signature += ", ";
+            outs() << ", ::godot::PropertyInfo(" << param.Type.VariantType << ", " << nameFunction << "("
+                << NameIndex(param.Name) << "))";
         }
-        signal.Signature += param.Signature;
-        // TODO: if paramName is empty!
-        signal.ArgNames.push_back(param.Name);
+        outs() << "));\n";
     }
-    outs() << "));\n";
+    bool errorReturn = false;
     auto returnType = GetUnderlyingType(declaration->getReturnType());
     if(CXXRecordDecl* cls = returnType->getAsCXXRecordDecl())
     {
         if(IsInGodotNamespace(cls) && (cls->getName() == "Error"))
         {
-            signal.ErrorReturn = true;
+            errorReturn = true;
         }
     }
-    if(!signal.ErrorReturn && !returnType->isVoidType())
+    if(!errorReturn && !returnType->isVoidType())
     {
-        GenerateError(*context, signal.Location, DiagnosticsEngine::Error,
+        GenerateError(*context, declaration->getLocation(), DiagnosticsEngine::Error,
             "Signal '%0' must be void return or have godot::Error return type", name);
     }
+
+    // The signal call function is defined after _bind_methods (see WriteSignals)
+    signals << '\n';
+    signals.indent(4*writtenNS) << ((errorReturn) ? "::godot::Error" : "void") << ' ' << currentClass
+        << "::" << name << '(';
+    for(std::size_t i = 0; i < arguments.size(); ++i)
+    {
+        signals << ((i == 0) ? "" : ", ") << arguments[i].Signature;
+    }
+    signals << ")\n";
+    signals.indent(4*writtenNS) << "{\n";
+    signals.indent(4*(writtenNS + 1)) << ((errorReturn) ? "return " : "") << "emit_signal(" << nameFunction << "(" << NameIndex(name) << ")";
+    for(const auto& param : arguments)
+    {
+        signals << ", " << param.Name;
+    }
+    signals << ");\n";
+    signals.indent(4*writtenNS) << "}\n";
 }
 
-void ExtractInterfaceVisitor::ProcessPropertyFunc(const std::string&,
-    CXXMethodDecl* declaration, const Property&, const std::string& function, bool)
+void ExtractInterfaceVisitor::ProcessPropertyFunc(const StringRef&,
+    CXXMethodDecl* declaration, const Property&, const StringRef& function, bool)
 {
     ProcessMethod(function, declaration, false, true);
 }
 
-void ExtractInterfaceVisitor::ProcessProperty(const std::string& propertyName, const Property& property)
+void ExtractInterfaceVisitor::ProcessProperty(const StringRef& propertyName, const Property& property)
 {
-    IndentFunc() << "ADD_PROPERTY(::godot::PropertyInfo(" << property.Type.VariantType << ", \""
-        << propertyName << "\", " << property.Hint << ", \"" << property.HintString << "\", "
-        << property.Usage << "), \"" << property.Setter << "\", \"" << property.Getter << "\");\n";
+    PhaseScope scope(Phase::Emission, "ExtractInterfaceVisitor::Emit");
+    if(tables)
+    {
+        llvm::raw_svector_ostream row(propertyTable);
+        row.indent(4*(writtenNS + 2)) << "{GDExportPropertyKind::Property, " << property.Type.VariantType
+            << ", " << NameIndex(propertyName) << ", " << property.Hint << ", \"" << property.HintString << "\", "
+            << property.Usage << ", " << NameIndex(property.Setter) << ", " << NameIndex(property.Getter) << "},\n";
+        return;
+    }
+    IndentFunc() << "ADD_PROPERTY(::godot::PropertyInfo(" << property.Type.VariantType << ", " << nameFunction << "("
+        << NameIndex(propertyName) << "), " << property.Hint << ", \"" << property.HintString << "\", "
+        << property.Usage << "), " << nameFunction << "(" << NameIndex(property.Setter) << "), " << nameFunction << "("
+        << NameIndex(property.Getter) << "));\n";
 }
 
-void ExtractInterfaceVisitor::ProcessMethod(const std::string& name, CXXMethodDecl* declaration,
+void ExtractInterfaceVisitor::ProcessMethod(const StringRef& name, CXXMethodDecl* declaration,
     bool isStatic, bool isProperty)
 {
     std::vector<FunctionArgument> args;
@@ -377,46 +867,58 @@ void ExtractInterfaceVisitor::ProcessMethod(const std::string& name, CXXMethodDe
     auto end = declaration->param_end();
     for(auto it = declaration->param_begin(); it != end; ++it)
     {
-        auto paramName = (*it)->getQualifiedNameAsString();
+        StringRef paramName = (*it)->getName();
         if(paramName.empty())
         {
-            paramName = "arg" + std::to_string(args.size());
+            paramName = strings.save("arg" + Twine(args.size()));
         }
-        std::optional<std::string> defaultVal;
+        std::optional<StringRef> defaultVal;
         auto* defaultArg = (*it)->getDefaultArg();
         if(defaultArg)
         {
             defaultVal = GetRawSource(*context, defaultArg);
         }
-        args.emplace_back(paramName, (*it)->getType(), GetRawSource(*context, *it), "", defaultVal);
+        args.emplace_back(paramName, typeCache.Get((*it)->getType()), GetRawSource(*context, *it), defaultVal);
     }
     std::optional<GodotType> returnType;
     auto type = GetUnderlyingType(declaration->getReturnType());
     if(!type->isVoidType())
     {
-        returnType = GodotType{declaration->getReturnType()};
+        returnType = typeCache.Get(declaration->getReturnType());
     }
     ProcessMethod(name, declaration, isStatic, isProperty, args, returnType);
+    for(auto& sink : sinks)
+    {
+        sink->ProcessMethod(name, declaration, isStatic, isProperty, args, returnType);
+    }
 }
 
-void ExtractInterfaceVisitor::ProcessMethod(const std::string& name, CXXMethodDecl* declaration,
+void ExtractInterfaceVisitor::ProcessMethod(const StringRef& name, CXXMethodDecl* declaration,
     bool isStatic, bool isProperty, const std::vector<FunctionArgument>& arguments,
     const std::optional<GodotType>& returnType)
 {
+    PhaseScope scope(Phase::Emission, "ExtractInterfaceVisitor::Emit");
+    // Property getters and setters are always bound with ClassDB::bind_method, as ClassDB::add_property
+    // looks them up in godot-cpp's map of bound methods (which the thunks are not added to). So are
+    // methods using private or protected types, which the signature's functions can not name
+    if(thunks && !isProperty && HasPublicSignature(declaration))
+    {
+        WriteThunks(name, declaration, isStatic, arguments, returnType.has_value());
+        return;
+    }
     IndentFunc();
     if(isStatic)
     {
-        outs() << "::godot::ClassDB::bind_static_method(\"" << currentClass
-            << "\", ::godot::D_METHOD(\"" << name << '\"';
+        outs() << "::godot::ClassDB::bind_static_method(get_class_static(), ::godot::D_METHOD(" << nameFunction << "("
+            << NameIndex(name) << ")";
     }
     else
     {
-        outs() << "::godot::ClassDB::bind_method(::godot::D_METHOD(\""
-            << name << '\"';
+        outs() << "::godot::ClassDB::bind_method(::godot::D_METHOD(" << nameFunction << "(" << NameIndex(name) << ")";
     }
     for(const auto& param : arguments)
     {
-        outs() << ", \"" << param.Name << "\"";
+        outs() << ", " << nameFunction << "(" << NameIndex(param.Name) << ")";
     }
     outs() << "), &" << currentClass << "::" << name;
     for(const auto& param : arguments)
@@ -431,6 +933,7 @@ void ExtractInterfaceVisitor::ProcessMethod(const std::string& name, CXXMethodDe
 
 void ExtractInterfaceVisitor::ProcessConstant(ConstantType type, const StringRef& name, EnumConstantDecl*)
 {
+    PhaseScope scope(Phase::Emission, "ExtractInterfaceVisitor::Emit");
     switch(type)
     {
     case ConstantType::Enum:
@@ -452,7 +955,10 @@ void ExtractInterfaceVisitor::WriteProperties()
 {
     if(!properties.empty())
     {
-        outs() << '\n';
+        if(!tables)
+        {
+            outs() << '\n';
+        }
         for(auto& [name, property] : properties)
         {
             if(property.Getter.empty())
@@ -462,26 +968,30 @@ void ExtractInterfaceVisitor::WriteProperties()
             }
             if(property.Hint.empty())
             {
-                if(property.Type.EnumValues.empty())
+                if(!property.Type.EnumValues || property.Type.EnumValues->empty())
                 {
                     property.Hint = "::godot::PROPERTY_HINT_NONE";
                 }
                 else if(property.Type.IsBitfield)
                 {
                     property.Hint = "::godot::PROPERTY_HINT_FLAGS";
-                    property.HintString = Join(property.Type.EnumValues.begin(), property.Type.EnumValues.end());
+                    property.HintString = strings.save(Join(property.Type.EnumValues->begin(), property.Type.EnumValues->end()));
                 }
                 else
                 {
                     property.Hint = "::godot::PROPERTY_HINT_ENUM";
-                    property.HintString = Join(property.Type.EnumValues.begin(), property.Type.EnumValues.end());
+                    property.HintString = strings.save(Join(property.Type.EnumValues->begin(), property.Type.EnumValues->end()));
                 }
             }
             if(property.Usage.empty())
             {
-                property.Usage = "::godot::PropertyHint::";
+                property.Usage = "::godot::PROPERTY_USAGE_DEFAULT";
             }
             ProcessProperty(name, property);
+            for(auto& sink : sinks)
+            {
+                sink->ProcessProperty(name, property);
+            }
         }
         properties.clear();
     }
@@ -489,25 +999,246 @@ void ExtractInterfaceVisitor::WriteProperties()
 
 void ExtractInterfaceVisitor::WriteSignals()
 {
-    for(const auto& signal : signals)
+    outs() << signalBuffer;
+    signalBuffer.clear();
+}
+
+void ExtractInterfaceVisitor::WriteTables()
+{
+    if(!propertyTable.empty())
     {
-        const char* returnType = (signal.ErrorReturn) ? "::godot::Error" : "void";
-        outs() << "\n";
-        Indent() << returnType << ' ' << currentClass << "::" << signal.Name
-            << '(' << signal.Signature << ")\n";
-        Indent() << "{\n";
-        IndentFunc();
-        if(signal.ErrorReturn)
+        outs() << '\n';
+        IndentFunc() << "static constexpr GDExportProperty gdexport_properties[] = {\n" << propertyTable;
+        IndentFunc() << "};\n";
+        IndentFunc() << "GDExportAddProperties(get_class_static(), " << nameFunction << ", gdexport_properties,\n";
+        Indent(writtenNS + 2) << "sizeof(gdexport_properties) / sizeof(gdexport_properties[0]));\n";
+        propertyTable.clear();
+    }
+    if(!signalTable.empty())
+    {
+        outs() << '\n';
+        if(!signalArguments.empty())
+        {
+            IndentFunc() << "static constexpr GDExportSignalArgument gdexport_signal_arguments[] = {\n"
+                << signalArguments;
+            IndentFunc() << "};\n";
+        }
+        IndentFunc() << "static constexpr GDExportSignal gdexport_signals[] = {\n" << signalTable;
+        IndentFunc() << "};\n";
+        IndentFunc() << "GDExportAddSignals(get_class_static(), " << nameFunction << ", gdexport_signals,\n";
+        Indent(writtenNS + 2) << "sizeof(gdexport_signals) / sizeof(gdexport_signals[0]));\n";
+        signalTable.clear();
+        signalArguments.clear();
+        signalArgumentCount = 0;
+    }
+}
+
+void ExtractInterfaceVisitor::WriteThunks(const StringRef& name, CXXMethodDecl* declaration, bool isStatic,
+    const std::vector<FunctionArgument>& arguments, bool hasReturn)
+{
+    auto policy = context->getPrintingPolicy();
+    std::vector<std::string> types;
+    types.reserve(arguments.size());
+    for(auto* param : declaration->parameters())
+    {
+        types.push_back(TypeName::getFullyQualifiedName(param->getType(), *context, policy, true));
+    }
+    std::string returnType = TypeName::getFullyQualifiedName(declaration->getReturnType(), *context, policy, true);
+    std::size_t firstDefault = arguments.size();
+    while((firstDefault > 0) && arguments[firstDefault - 1].Default)
+    {
+        --firstDefault;
+    }
+    std::size_t indent = writtenNS + 2;
+    std::string signature = SignatureThunks(returnType, types, hasReturn);
+
+    IndentFunc() << "{\n";
+    if(!arguments.empty())
+    {
+        Indent(indent) << "static const GDExtensionClassMethodArgumentMetadata gdexport_metadata[] = {";
+        for(std::size_t i = 0; i != arguments.size(); ++i)
+        {
+            outs() << ((i) ? ", " : "") << "::godot::GetTypeInfo<" << types[i] << ">::METADATA";
+        }
+        outs() << "};\n";
+        Indent(indent) << "const ::godot::PropertyInfo gdexport_arguments[] = {\n";
+        for(std::size_t i = 0; i != arguments.size(); ++i)
         {
-            outs() << "return ";
+            Indent(indent + 1) << "GDExportNamedInfo(::godot::GetTypeInfo<" << types[i]
+                << ">::get_class_info(), " << nameFunction << "(" << NameIndex(arguments[i].Name) << ")),\n";
         }
-        outs() << "emit_signal(\"" << signal.Name << '\"';
-        for(const auto& arg : signal.ArgNames)
+        Indent(indent) << "};\n";
+    }
+    if(firstDefault != arguments.size())
+    {
+        Indent(indent) << "static const ::godot::Variant gdexport_defaults[] = {";
+        for(std::size_t i = firstDefault; i != arguments.size(); ++i)
+        {
+            outs() << ((i != firstDefault) ? ", " : "") << "::godot::Variant(" << *arguments[i].Default << ")";
+        }
+        outs() << "};\n";
+    }
+    if(hasReturn)
+    {
+        Indent(indent) << "const ::godot::PropertyInfo gdexport_return = ::godot::GetTypeInfo<"
+            << returnType << ">::get_class_info();\n";
+    }
+
+    // The only code for the method: a function calling the method with the native arguments,
+    // which the call and ptrcall functions of the signature call (after converting the arguments)
+    Indent(indent) << "static const ::gdexport::GDExportMethod gdexport_method{\n";
+    Indent(indent + 1) << "reinterpret_cast<::gdexport::GDExportFunction>(+[](GDExtensionClassInstancePtr"
+        << ((isStatic) ? "" : " instance");
+    for(std::size_t i = 0; i != arguments.size(); ++i)
+    {
+        outs() << ", " << types[i] << " arg" << i;
+    }
+    outs() << ") -> " << returnType << "\n";
+    Indent(indent + 2) << "{\n";
+    Indent(indent + 3) << "return ";
+    if(isStatic)
+    {
+        outs() << currentClass << "::";
+    }
+    else
+    {
+        outs() << "reinterpret_cast<" << currentClass << "*>(instance)->";
+    }
+    outs() << name << "(";
+    for(std::size_t i = 0; i != arguments.size(); ++i)
+    {
+        outs() << ((i) ? ", " : "") << "std::forward<" << types[i] << ">(arg" << i << ")";
+    }
+    outs() << ");\n";
+    Indent(indent + 2) << "}),\n";
+    Indent(indent + 1) << ((firstDefault != arguments.size()) ? "gdexport_defaults" : "nullptr") << ", "
+        << firstDefault << "};\n";
+
+    Indent(indent) << "GDExportBindMethod(get_class_static(), " << nameFunction << "(" << NameIndex(name)
+        << "), GDEXTENSION_METHOD_FLAGS_DEFAULT";
+    if(isStatic)
+    {
+        outs() << " | GDEXTENSION_METHOD_FLAG_STATIC";
+    }
+    else if(declaration->isConst())
+    {
+        outs() << " | GDEXTENSION_METHOD_FLAG_CONST";
+    }
+    outs() << ",\n";
+    Indent(indent + 1) << "&gdexport_method, &::gdexport::GDExportCall_" << signature
+        << ", &::gdexport::GDExportPtrCall_" << signature << ",\n";
+    Indent(indent + 1) << ((hasReturn) ? "&gdexport_return, ::godot::GetTypeInfo<" + returnType + ">::METADATA"
+        : std::string("nullptr, GDEXTENSION_METHOD_ARGUMENT_METADATA_NONE")) << ",\n";
+    if(arguments.empty())
+    {
+        Indent(indent + 1) << "nullptr, nullptr, 0, ";
+    }
+    else
+    {
+        Indent(indent + 1) << "gdexport_arguments, gdexport_metadata, " << arguments.size() << ", ";
+    }
+    if(firstDefault != arguments.size())
+    {
+        outs() << "gdexport_defaults, " << (arguments.size() - firstDefault) << ");\n";
+    }
+    else
+    {
+        outs() << "nullptr, 0);\n";
+    }
+    IndentFunc() << "}\n";
+}
+
+std::string ExtractInterfaceVisitor::SignatureThunks(const std::string& returnType,
+    const std::vector<std::string>& types, bool hasReturn)
+{
+    std::string key = returnType + "(" + llvm::join(types, ", ") + ")";
+    auto found = signatureNames.find(key);
+    if(found != signatureNames.end())
+    {
+        return found->second;
+    }
+    // Named from a hash of the signature, so the functions for the same signature in different
+    // generated files have the same name (and the guard macro skips them in a jumbo file)
+    std::string signature = llvm::utohexstr(llvm::xxh3_64bits(llvm::arrayRefFromStringRef(key)), true, 16);
+    signatureNames.emplace(key, signature);
+
+    std::string function = returnType + " (*)(GDExtensionClassInstancePtr";
+    for(const auto& type : types)
+    {
+        function += ", " + type;
+    }
+    function += ")";
+
+    signatureThunks << "#ifndef GDEXPORT_SIGNATURE_" << signature << "\n"
+        "#define GDEXPORT_SIGNATURE_" << signature << "\n"
+        "namespace gdexport\n{\n"
+        "    // " << key << "\n"
+        "    inline void GDExportCall_" << signature << "(void* userdata, GDExtensionClassInstancePtr instance,\n"
+        "        const GDExtensionConstVariantPtr* args, GDExtensionInt count, GDExtensionVariantPtr ret,\n"
+        "        GDExtensionCallError* error)\n"
+        "    {\n";
+    if(!types.empty())
+    {
+        signatureThunks << "        static constexpr GDExtensionVariantType types[] = {";
+        for(std::size_t i = 0; i != types.size(); ++i)
         {
-            outs() << ", " << arg;
+            signatureThunks << ((i) ? ", " : "") << "::godot::GetTypeInfo<" << types[i] << ">::VARIANT_TYPE";
         }
-        outs() << ");\n";
-        Indent() << "}\n";
+        signatureThunks << "};\n";
+    }
+    signatureThunks << "        const auto* method = static_cast<const GDExportMethod*>(userdata);\n"
+        "        if(!GDExportCheckCall(args, count, " << ((types.empty()) ? "nullptr" : "types") << ", "
+        << types.size() << ", method->FirstDefault, error))\n"
+        "        {\n"
+        "            return;\n"
+        "        }\n"
+        "        ";
+    if(hasReturn)
+    {
+        signatureThunks << "*reinterpret_cast<::godot::Variant*>(ret) = ";
+    }
+    signatureThunks << "reinterpret_cast<" << function << ">(method->Function)(instance";
+    for(std::size_t i = 0; i != types.size(); ++i)
+    {
+        signatureThunks << ",\n            ::godot::VariantCaster<" << types[i]
+            << ">::cast(GDExportArgument(args, count, " << i << ", method))";
+    }
+    signatureThunks << ");\n"
+        "    }\n"
+        "\n"
+        "    inline void GDExportPtrCall_" << signature << "(void* userdata, GDExtensionClassInstancePtr instance,\n"
+        "        const GDExtensionConstTypePtr* args, GDExtensionTypePtr ret)\n"
+        "    {\n"
+        "        auto function = reinterpret_cast<" << function
+        << ">(static_cast<const GDExportMethod*>(userdata)->Function);\n"
+        "        ";
+    if(hasReturn)
+    {
+        signatureThunks << "::godot::PtrToArg<" << returnType << ">::encode(";
+    }
+    signatureThunks << "function(instance";
+    for(std::size_t i = 0; i != types.size(); ++i)
+    {
+        signatureThunks << ",\n            ::godot::PtrToArg<" << types[i] << ">::convert(args[" << i << "])";
+    }
+    signatureThunks << ((hasReturn) ? "), ret);\n" : ");\n") <<
+        "    }\n"
+        "}\n"
+        "#endif // GDEXPORT_SIGNATURE_" << signature << "\n\n";
+    return signature;
+}
+
+std::size_t ExtractInterfaceVisitor::NameIndex(const StringRef& name)
+{
+    auto it = nameIndices.find(name);
+    if(it != nameIndices.end())
+    {
+        return it->second;
     }
-    signals.clear();
+    // Copied, as the table is written by the destructor, after the AST (which owns the names of
+    // declarations and string literals) may have been freed (e.g., by the batch driver)
+    StringRef saved = strings.save(name);
+    nameIndices.emplace(saved, names.size());
+    names.push_back(saved);
+    return names.size() - 1;
 }
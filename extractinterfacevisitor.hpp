@@ -7,109 +7,122 @@
 #include "clang/AST/ASTContext.h"
 #include "clang/AST/RecursiveASTVisitor.h"
 #include "clang/Basic/SourceLocation.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/Allocator.h"
+#include "llvm/Support/StringSaver.h"
+#include "llvm/Support/raw_ostream.h"
 
 #include "utilities.hpp"
 
-using namespace clang;
-
-template<class Map, class It>
-class InsertionOrderedMapIterator
-{
-public:
-    typedef std::forward_iterator_tag iterator_category;
-    typedef typename Map::difference_type difference_type;
-    typedef typename Map::value_type value_type;
-    typedef typename Map::pointer pointer;
-    typedef typename Map::reference reference;
-
-    InsertionOrderedMapIterator(Map* map, It it) : entries(map), iterator(it) { }
-
-    reference operator*() const { return *entries->find(*iterator); }
-    pointer operator->() { return &(*entries->find(*iterator)); }
-
-    // Prefix increment
-    InsertionOrderedMapIterator& operator++() { iterator++; return *this; }
-
-    // Postfix increment
-    InsertionOrderedMapIterator operator++(int)
-    {
-        InsertionOrderedMapIterator tmp = *this;
-        ++(*this);
-        return tmp;
-    }
-
-    friend bool operator==(const InsertionOrderedMapIterator& lhs, const InsertionOrderedMapIterator& rhs)
-    {
-        return lhs.iterator == rhs.iterator;
-    };
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
-    friend bool operator!=(const InsertionOrderedMapIterator& lhs, const InsertionOrderedMapIterator& rhs)
-    {
-        return lhs.iterator != rhs.iterator;
-    };
+using namespace clang;
 
-private:
-    Map* entries;
-    It iterator;
-};
+class InterfaceSink;
 
+/**
+ * Map which iterates over its entries in the order the keys were first inserted
+ *
+ * The entries are stored contiguously (in insertion order), and are found through an
+ * open-addressing (linear probing) index of the positions of the entries; so each key is stored
+ * once and iteration is a linear scan. Inserting an entry invalidates iterators and references
+ * to the existing entries.
+ */
 template<class K, class V, class Hash = std::hash<K>, class KeyEqual = std::equal_to<K>>
 class InsertionOrderedMap
 {
 public:
-    typedef typename std::unordered_map<K,V,Hash,KeyEqual>::key_type key_type;
-    typedef typename std::unordered_map<K,V,Hash,KeyEqual>::mapped_type mapped_type;
-    typedef typename std::unordered_map<K,V,Hash,KeyEqual>::value_type value_type;
-    typedef typename std::unordered_map<K,V,Hash,KeyEqual>::size_type size_type;
-    typedef typename std::unordered_map<K,V,Hash,KeyEqual>::difference_type difference_type;
-    typedef typename std::unordered_map<K,V,Hash,KeyEqual>::hasher hasher;
-    typedef typename std::unordered_map<K,V,Hash,KeyEqual>::key_equal key_equal;
-    typedef typename std::unordered_map<K,V,Hash,KeyEqual>::allocator_type allocator_type;
-    typedef typename std::unordered_map<K,V,Hash,KeyEqual>::reference reference;
-    typedef typename std::unordered_map<K,V,Hash,KeyEqual>::const_reference const_reference;
-    typedef typename std::unordered_map<K,V,Hash,KeyEqual>::pointer pointer;
-    typedef typename std::unordered_map<K,V,Hash,KeyEqual>::const_pointer const_pointer;
-    typedef InsertionOrderedMapIterator<
-            std::unordered_map<K,V,Hash,KeyEqual>,
-            typename std::vector<K>::iterator
-        > iterator;
-    typedef InsertionOrderedMapIterator<
-            const std::unordered_map<K,V,Hash,KeyEqual>,
-            typename std::vector<K>::const_iterator
-        > const_iterator;
-
-    InsertionOrderedMap() : entries(), keys() { }
+    typedef K key_type;
+    typedef V mapped_type;
+    typedef std::pair<const K, V> value_type;
+    typedef typename std::vector<value_type>::size_type size_type;
+    typedef typename std::vector<value_type>::difference_type difference_type;
+    typedef Hash hasher;
+    typedef KeyEqual key_equal;
+    typedef typename std::vector<value_type>::allocator_type allocator_type;
+    typedef value_type& reference;
+    typedef const value_type& const_reference;
+    typedef value_type* pointer;
+    typedef const value_type* const_pointer;
+    typedef typename std::vector<value_type>::iterator iterator;
+    typedef typename std::vector<value_type>::const_iterator const_iterator;
+
+    InsertionOrderedMap() : entries(), slots(), hash(), equal() { }
 
     mapped_type& operator[](const K& key)
     {
-        keys.push_back(std::string{key});
-        auto result = entries.try_emplace(keys.back());
-        if(!result.second)
+        // Keep the index at most 3/4 full, so the probe sequences stay short
+        if((entries.size() + 1) * 4 > slots.size() * 3)
+        {
+            Rehash(std::max<size_type>(16, slots.size() * 2));
+        }
+        size_type mask = slots.size() - 1;
+        for(size_type i = hash(key) & mask; ; i = (i + 1) & mask)
         {
-            keys.pop_back();
+            if(slots[i] == 0)
+            {
+                entries.emplace_back(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple());
+                slots[i] = static_cast<Slot>(entries.size());
+                return entries.back().second;
+            }
+            auto& entry = entries[slots[i] - 1];
+            if(equal(entry.first, key))
+            {
+                return entry.second;
+            }
         }
-        return result.first->second;
     }
 
     bool empty() const { return entries.empty(); }
 
+    size_type size() const { return entries.size(); }
+
     void clear()
     {
         entries.clear();
-        keys.clear();
+        std::fill(slots.begin(), slots.end(), 0);
     }
 
-    iterator begin() { return iterator(&entries, keys.begin()); }
-    const_iterator begin() const { return const_iterator(entries, keys.cbegin()); }
-    const_iterator cbegin() const { return const_iterator(entries, keys.cbegin()); }
+    iterator begin() { return entries.begin(); }
+    const_iterator begin() const { return entries.cbegin(); }
+    const_iterator cbegin() const { return entries.cbegin(); }
 
-    iterator end() { return iterator(&entries, keys.end()); }
-    const_iterator end() const { return const_iterator(entries, keys.cend()); }
-    const_iterator cend() const { return const_iterator(entries, keys.cend()); }
+    iterator end() { return entries.end(); }
+    const_iterator end() const { return entries.cend(); }
+    const_iterator cend() const { return entries.cend(); }
 
 private:
-    std::unordered_map<K, V, Hash, KeyEqual> entries;
-    std::vector<K> keys;
+    /**
+     * Position of an entry in the index: 0 for an empty slot; otherwise, one more than the
+     * position of the entry in entries
+     */
+    typedef uint32_t Slot;
+
+    void Rehash(size_type count)
+    {
+        slots.assign(count, 0);
+        size_type mask = count - 1;
+        for(size_type pos = 0; pos != entries.size(); ++pos)
+        {
+            size_type i = hash(entries[pos].first) & mask;
+            while(slots[i] != 0)
+            {
+                i = (i + 1) & mask;
+            }
+            slots[i] = static_cast<Slot>(pos + 1);
+        }
+    }
+
+    std::vector<value_type> entries;
+    std::vector<Slot> slots;
+    Hash hash;
+    KeyEqual equal;
 };
 
 /**
@@ -124,12 +137,64 @@ public:
      * @param ctxt The AST context
      * @param outFile Output stream to write the generated code to
      * @param funcName The name of the function to call to export the classes/methods
+     * @param tables true to register the properties and signals from constant tables (with a loop),
+     *               rather than a separate call for each property and signal
+     * @param thunks true to bind the methods (except property getters and setters) with generated
+     *               (non-template) call and ptrcall functions, rather than godot-cpp's MethodBind
+     *               templates
      */
     ExtractInterfaceVisitor(ASTContext* ctxt, std::unique_ptr<llvm::raw_pwrite_stream>&& outFile,
-        const std::string& funcName);
+        const std::string& funcName, bool tables = false, bool thunks = false);
 
     ~ExtractInterfaceVisitor();
 
+    /**
+     * Information about a class marked with `[[godot::class]]` or `[[godot::tool]]` which is exported
+     */
+    struct ExportedClass
+    {
+        /**
+         * The name of the class
+         */
+        std::string Name;
+        /**
+         * The fully-qualified name of the class
+         */
+        std::string QualifiedName;
+        /**
+         * Specifies if the class was marked as `[[godot::tool]]`
+         */
+        bool Tool;
+        /**
+         * The name of the class inherited from (the first base class), qualified as for
+         * QualifiedName, or empty if the class has no base class
+         */
+        std::string Base;
+    };
+
+    /**
+     * Gets the classes exported so far, in the order they were encountered in the AST
+     *
+     * @return The exported classes
+     */
+    const std::vector<ExportedClass>& Classes() const { return classes; }
+
+    /**
+     * Add a sink to receive the classes, methods, properties, etc. decoded during the traversal
+     * (in addition to the code generated by this visitor)
+     *
+     * @param sink The sink to add
+     */
+    void AddSink(std::unique_ptr<InterfaceSink>&& sink);
+
+    /**
+     * Method to call once the whole translation unit has been traversed; calls
+     * InterfaceSink::EndTranslationUnit for each sink
+     *
+     * Overrides MUST call this base method.
+     */
+    virtual void EndTranslationUnit();
+
     bool TraverseNamespaceDecl(NamespaceDecl* declaration);
     bool TraverseCXXRecordDecl(CXXRecordDecl* declaration);
     bool TraverseEnumDecl(EnumDecl* declaration);
@@ -170,15 +235,21 @@ protected:
     }
 
     /**
-     * Gets the output stream for the file
+     * Gets the output stream for the file (buffered when writing thunks, so the call and ptrcall
+     * functions of each signature can be written before the first class)
      *
      * @return The output stream
      */
     llvm::raw_ostream& outs()
     {
+        if(thunks)
+        {
+            return body;
+        }
         return (output) ? *output : llvm::outs();
     }
 
+public:
     /**
      * Struct for holding information for a property (member) of a godot class
      */
@@ -197,11 +268,11 @@ protected:
         /**
          * The name of the getter method
          */
-        std::string Getter;
+        StringRef Getter;
         /**
          * The name of the setter method
          */
-        std::string Setter;
+        StringRef Setter;
         /**
          * The type of the member
          */
@@ -213,7 +284,7 @@ protected:
         /**
          * The string for the hint
          */
-        std::string HintString;
+        StringRef HintString;
         /**
          * The fully qualified enum value for the usage of the member (godot::PropertyUsageFlags)
          */
@@ -238,15 +309,14 @@ protected:
          * Creates information about an argument to a method or signal
          *
          * @param name The name of the argument
-         * @param type The AST qualified type of the argument (passed to GodotType constructor)
+         * @param type The resolved type of the argument (see GodotTypeCache)
          * @param signature The C++ signature (raw source) for the argument
-         * @param variantHint Optional hint for the variant type (passed to GodotType constructor)
          * @param defaultVal Optional default value for the argument
          */
-        FunctionArgument(const std::string& name, const QualType& type, const StringRef& signature,
-                const std::string& variantHint = "", const std::optional<std::string>& defaultVal = {})
+        FunctionArgument(const StringRef& name, const GodotType& type, const StringRef& signature,
+                const std::optional<StringRef>& defaultVal = {})
             : Name(name)
-            , Type(type, variantHint)
+            , Type(type)
             , Signature(signature)
             , Default(defaultVal)
         {
@@ -255,7 +325,7 @@ protected:
         /**
          * The name of the argument
          */
-        std::string Name;
+        StringRef Name;
         /**
          * The type of the argument
          */
@@ -263,12 +333,12 @@ protected:
         /**
          * The C++ signature (raw source) for the argument
          */
-        std::string Signature;
+        StringRef Signature;
         /**
          * The (optional) default value for the argument (raw source)
          *
          */
-        std::optional<std::string> Default;
+        std::optional<StringRef> Default;
     };
 
     /**
@@ -294,6 +364,7 @@ protected:
         Constants
     };
 
+protected:
     /**
      * Method called when a class marked with `[[godot::class]]` or `[[godot::tool]]` is encountered in the AST.
      *
@@ -335,13 +406,13 @@ protected:
      * @param prefix The prefix required for members to be part of the group
      * @param subgroup true if a subgroup; false if a group
      */
-    virtual void ProcessGroup(const std::string& name, const std::string& prefix, bool subgroup);
+    virtual void ProcessGroup(const StringRef& name, const StringRef& prefix, bool subgroup);
 
     /**
      * Method called when encountering a method marked with `[[godot::signal]]`.
      *
-     * Writes the necessary exports for defining the signal, and sets up a the necessary data for
-     * the signal to be used on ProcessEndClass to define the body of the signal call function.
+     * Writes the necessary exports for defining the signal, and writes the definition of the signal
+     * call function to a buffer which is output on ProcessEndClass (after `_bind_methods`).
      *
      * Overrides MUST call this base method.
      *
@@ -349,7 +420,7 @@ protected:
      * @param declaration The declaration of the method
      * @param arguments The arguments to the method
      */
-    virtual void ProcessSignal(const std::string& name, CXXMethodDecl* declaration,
+    virtual void ProcessSignal(const StringRef& name, CXXMethodDecl* declaration,
         const std::vector<FunctionArgument>& arguments);
 
     /**
@@ -366,8 +437,8 @@ protected:
      * @param function The name of the method
      * @param isSetter true if the setter function for the property, or false if the getter
      */
-    virtual void ProcessPropertyFunc(const std::string& propertyName, CXXMethodDecl* declaration,
-        const Property& property, const std::string& function, bool isSetter);
+    virtual void ProcessPropertyFunc(const StringRef& propertyName, CXXMethodDecl* declaration,
+        const Property& property, const StringRef& function, bool isSetter);
 
     /**
      * Method called when the property information is output (during call to ProcessEndClass); at
@@ -380,7 +451,7 @@ protected:
      * @param propertyName The name of the property
      * @param property Information about the property
      */
-    virtual void ProcessProperty(const std::string& propertyName, const Property& property);
+    virtual void ProcessProperty(const StringRef& propertyName, const Property& property);
 
     /**
      * Method called when encountering a method marked with `[[godot::getter]]`, `[[godot::setter]]`
@@ -397,7 +468,7 @@ protected:
      * @param arguments The arguments to the method
      * @param returnType Optional information about the return type of the method
      */
-    virtual void ProcessMethod(const std::string& name, CXXMethodDecl* declaration, bool isStatic, bool isProperty,
+    virtual void ProcessMethod(const StringRef& name, CXXMethodDecl* declaration, bool isStatic, bool isProperty,
             const std::vector<FunctionArgument>& arguments, const std::optional<GodotType>& returnType);
 
     /**
@@ -433,7 +504,7 @@ private:
      * @param isStatic true if the method is a static method; false if an instance method
      * @param isProperty true if the function is a property getter/setter; false if normal method
      */
-    void ProcessMethod(const std::string& name, CXXMethodDecl* declaration, bool isStatic, bool isProperty = false);
+    void ProcessMethod(const StringRef& name, CXXMethodDecl* declaration, bool isStatic, bool isProperty = false);
 
     /**
      * Write the export information for the current properties
@@ -441,52 +512,74 @@ private:
     void WriteProperties();
 
     /**
-     * Write the definition of the signal functions
+     * Write the definition of the signal call functions (buffered by ProcessSignal)
      */
     void WriteSignals();
 
     /**
-     * Stores information about a signal
+     * Write the tables of the properties and signals of the current class, and the loops to
+     * register them (when writing tables)
      */
-    struct SignalData
-    {
-        /**
-         * Creates information about a signal
-         *
-         * @param signal The name of the signal
-         * @param loc  The source location of the method declaration for the signal
-         */
-        SignalData(const std::string& signal, const SourceLocation& loc)
-            : Name(signal), Location(loc), Signature(), ArgNames(), ErrorReturn(false)
-        {
-        }
+    void WriteTables();
 
-        /**
-         * The name of the signal
-         */
-        std::string Name;
-        /**
-         * The source location of the method declaration for the signal
-         */
-        SourceLocation Location;
-        /**
-         * The argument signature of the signal
-         */
-        std::string Signature;
-        /**
-         * List of arguments names of the arguments of the signature
-         */
-        std::vector<std::string> ArgNames;
-        /**
-         * true if the signal method returns godot::Error, false if void return
-         */
-        bool ErrorReturn;
-    };
+    /**
+     * Write the binding of a method with generated call and ptrcall functions (when writing thunks)
+     *
+     * @param name The name of the method
+     * @param declaration The declaration of the method
+     * @param isStatic true if the method is a static method; false if an instance method
+     * @param arguments The arguments to the method
+     * @param hasReturn true if the method returns a value; false if it returns void
+     */
+    void WriteThunks(const StringRef& name, CXXMethodDecl* declaration, bool isStatic,
+        const std::vector<FunctionArgument>& arguments, bool hasReturn);
+
+    /**
+     * Gets the name of the call and ptrcall functions (`gdexport::GDExportCall_<signature>` and
+     * `gdexport::GDExportPtrCall_<signature>`) for a method signature, writing the functions if not
+     * already written; so the argument conversions are only generated once for all the methods with
+     * the same signature (the functions call the method through the function in the method userdata)
+     *
+     * @param returnType The fully qualified return type of the method
+     * @param types The fully qualified types of the arguments
+     * @param hasReturn true if the method returns a value; false if it returns void
+     * @return The signature part of the name of the functions
+     */
+    std::string SignatureThunks(const std::string& returnType, const std::vector<std::string>& types,
+        bool hasReturn);
+
+    /**
+     * Gets the index of a name in the table of StringNames written at the end of the generated
+     * code (referenced as `GDExportName_<funcName>(index)`), adding the name to the table if not already
+     * present; so each distinct name is only interned once per translation unit
+     *
+     * @param name The name (copied, so need not outlive the AST)
+     * @return The index of the name in the table
+     */
+    std::size_t NameIndex(const StringRef& name);
 
     ASTContext* context;
-    std::vector<std::pair<std::string, bool>> classes;
-    InsertionOrderedMap<std::string, Property> properties;
-    std::vector<SignalData> signals;
+    std::vector<ExportedClass> classes;
+    std::vector<std::unique_ptr<InterfaceSink>> sinks;
+    llvm::BumpPtrAllocator allocator;
+    llvm::StringSaver strings;
+    GodotTypeCache typeCache;
+    InsertionOrderedMap<StringRef, Property> properties;
+    SmallString<0> signalBuffer;
+    llvm::raw_svector_ostream signals;
+    bool tables;
+    SmallString<0> propertyTable;
+    SmallString<0> signalTable;
+    SmallString<0> signalArguments;
+    std::size_t signalArgumentCount;
+    bool thunks;
+    SmallString<0> signatureBuffer;
+    llvm::raw_svector_ostream signatureThunks;
+    std::unordered_map<std::string, std::string> signatureNames;
+    SmallString<0> bodyBuffer;
+    llvm::raw_svector_ostream body;
+    std::unordered_map<StringRef, std::size_t> nameIndices;
+    std::vector<StringRef> names;
     std::vector<StringRef> currentNamespace;
     std::size_t writtenNS;
     StringRef currentClass;
@@ -495,6 +588,7 @@ private:
     std::unique_ptr<llvm::raw_pwrite_stream> output;
     std::string docFolder;
     std::string funcName;
+    std::string nameFunction;
 };
 
 #endif // GDEXPORT_EXTRACTINTERFACEVISITOR_HPP
@@ -1,19 +1,93 @@
 // SPDX-FileCopyrightText: 2025 Gridshadows Gaming <https://www.gridshadows.co.uk>
 // SPDX-License-Identifier: Zlib
 
+#include "gdexport.hpp"
 #include "extractinterfacevisitor.hpp"
 #include "extractdocvisitor.hpp"
+#include "interfacesink.hpp"
+#include "statistics.hpp"
+#include "utilities.hpp"
 
 #include "clang/AST/ASTContext.h"
 #include "clang/Frontend/FrontendAction.h"
 #include "clang/Frontend/FrontendPluginRegistry.h"
 #include "clang/AST/RecursiveASTVisitor.h"
 #include "clang/Frontend/CompilerInstance.h"
+#include "clang/Frontend/MultiplexConsumer.h"
+#include "clang/Frontend/Utils.h"
 
 #include <filesystem>
 
 using namespace clang;
 
+/**
+ * Base for consumers which only traverse the declarations in the main file.
+ *
+ * The top-level declarations in the main file are collected as they are parsed, and only these
+ * are traversed once the translation unit is complete, rather than the whole translation unit
+ * (which includes every declaration from the included godot-cpp headers).
+ */
+class MainFileConsumer : public ASTConsumer
+{
+public:
+    /**
+     * Construct consumer
+     *
+     * @param ctxt The AST context
+     * @param fullTU Specifies whether to traverse the whole translation unit instead of just the
+     *               declarations in the main file (the visitor must still ignore declarations
+     *               outside the main file)
+     */
+    MainFileConsumer(ASTContext* ctxt, bool fullTU)
+        : context(ctxt), fullTranslationUnit(fullTU), declarations()
+    {
+    }
+
+    virtual bool HandleTopLevelDecl(DeclGroupRef group) override
+    {
+        if(!fullTranslationUnit)
+        {
+            auto& sm = context->getSourceManager();
+            for(Decl* declaration : group)
+            {
+                if(sm.isInMainFile(declaration->getLocation()))
+                {
+                    declarations.push_back(declaration);
+                }
+            }
+        }
+        return true;
+    }
+
+protected:
+    /**
+     * Traverse the declarations in the main file (or the whole translation unit)
+     *
+     * @tparam VISITOR The type of the visitor
+     * @param visitor The visitor to traverse the declarations with
+     */
+    template<typename VISITOR>
+    void Traverse(VISITOR& visitor)
+    {
+        if(fullTranslationUnit)
+        {
+            visitor.TraverseDecl(context->getTranslationUnitDecl());
+        }
+        else
+        {
+            for(Decl* declaration : declarations)
+            {
+                visitor.TraverseDecl(declaration);
+            }
+        }
+    }
+
+private:
+    ASTContext* context;
+    bool fullTranslationUnit;
+    std::vector<Decl*> declarations;
+};
+
 /**
  * Visitor which print classes marked with [[godot::class]]
  *
@@ -35,8 +109,8 @@ public:
         {
             for(const auto& attr : declaration->specific_attrs<AnnotateAttr>())
             {
-                if((attr->getAnnotation() == "godot::class")
-                    || (attr->getAnnotation() == "godot::tool"))
+                auto kind = ClassifyAttribute(attr);
+                if((kind == GodotAttribute::Class) || (kind == GodotAttribute::Tool))
                 {
                     llvm::outs() << declaration->getName() << "\n";
                     break;
@@ -53,14 +127,17 @@ private:
 /**
  * Consumer for printing class names of classes marked with [[godot::class]]
  */
-class ExtractClassNamesConsumer : public ASTConsumer
+class ExtractClassNamesConsumer : public MainFileConsumer
 {
 public:
-    ExtractClassNamesConsumer(ASTContext* context) : visitor(context) { }
+    ExtractClassNamesConsumer(ASTContext* context, bool fullTU)
+        : MainFileConsumer(context, fullTU), visitor(context)
+    {
+    }
 
     virtual void HandleTranslationUnit(ASTContext& context)
     {
-        visitor.TraverseDecl(context.getTranslationUnitDecl());
+        Traverse(visitor);
     }
 
 private:
@@ -69,12 +146,13 @@ private:
 
 /**
  * Consumer for the AST with a visitor derived from ExtractInterfaceVisitor
- * (either ExtractInterfaceVisitor or ExtractDocVisitor)
+ * (either ExtractInterfaceVisitor or ExtractDocVisitor), and any sinks added to the visitor, which
+ * all receive the declarations from the same traversal of the AST
  *
  * @tparam VISITOR The type of the visitor for the AST
  */
 template<typename VISITOR>
-class ExtractInterfaceConsumer : public ASTConsumer
+class ExtractInterfaceConsumer : public MainFileConsumer
 {
 public:
     /**
@@ -82,18 +160,34 @@ public:
      *
      * @tparam Args Type of extra argumetns to apss to the visitor
      * @param context The AST context (forwarded to the visitor)
+     * @param fullTU Specifies whether to traverse the whole translation unit (see MainFileConsumer)
      * @param outFile Output stream to write the generated code to (forwarded to the visitor)
      * @param args Extra arguments to pass to the visitor
      */
     template<typename... Args>
-    ExtractInterfaceConsumer(ASTContext* context, std::unique_ptr<llvm::raw_pwrite_stream>&& outFile, Args... args)
-        : visitor(context, std::move(outFile), args...)
+    ExtractInterfaceConsumer(ASTContext* context, bool fullTU, std::unique_ptr<llvm::raw_pwrite_stream>&& outFile,
+            Args... args)
+        : MainFileConsumer(context, fullTU)
+        , visitor(context, std::move(outFile), args...)
+    {
+    }
+
+    /**
+     * Add a sink to the visitor
+     *
+     * @param sink The sink to add
+     */
+    void AddSink(std::unique_ptr<InterfaceSink>&& sink)
     {
+        visitor.AddSink(std::move(sink));
     }
 
     virtual void HandleTranslationUnit(ASTContext& context)
     {
-        visitor.TraverseDecl(context.getTranslationUnitDecl());
+        // Recorded in the statistics (with -stats), and shown in the time trace (with -ftime-trace)
+        PhaseScope scope(Phase::Traversal, "ExtractInterfaceVisitor");
+        Traverse(visitor);
+        visitor.EndTranslationUnit();
     }
 
 private:
@@ -101,155 +195,378 @@ private:
 };
 
 /**
- * Clang plugin for parsing the godot attributes and generating the export code
+ * Create a consumer for the AST with a visitor derived from ExtractInterfaceVisitor, with sinks
+ * added to the visitor
+ *
+ * @tparam VISITOR The type of the visitor for the AST
+ * @tparam Args Type of the arguments to pass to the consumer
+ * @param sinks The sinks to add to the visitor
+ * @param args The arguments to pass to the consumer
+ * @return The consumer
+ */
+template<typename VISITOR, typename... Args>
+static std::unique_ptr<ASTConsumer> CreateInterfaceConsumer(std::vector<std::unique_ptr<InterfaceSink>>&& sinks,
+    Args&&... args)
+{
+    auto extract = std::make_unique<ExtractInterfaceConsumer<VISITOR>>(std::forward<Args>(args)...);
+    for(auto& sink : sinks)
+    {
+        extract->AddSink(std::move(sink));
+    }
+    return extract;
+}
+
+/**
+ * Collects every file read while parsing the header, including system headers (e.g., godot-cpp),
+ * as any of them may change the generated code
  */
-class GenerateExtensionInterface : public PluginASTAction
+class HeaderDependencyCollector : public DependencyCollector
 {
-    // Hack: for some reason if these are just std::string clang crashes!
+public:
+    bool needSystemDependencies() override { return true; }
+};
 
+/**
+ * Consumer which writes a Makefile-style dependency file, listing the files collected by a
+ * HeaderDependencyCollector, once the translation unit has been parsed
+ */
+class WriteDependenciesConsumer : public ASTConsumer
+{
+public:
     /**
-     * Specifies the output file to write the generated code to (or empty for automatic name deduction)
+     * Construct consumer to write the dependency file
+     *
+     * @param collector The collector for the files the header depends on
+     * @param depsFile The dependency file to write
+     * @param target The target of the rule in the dependency file (the generated file)
      */
-    std::optional<std::string> outputFile;
+    WriteDependenciesConsumer(std::shared_ptr<HeaderDependencyCollector> collector,
+            const std::string& depsFile, const std::string& target)
+        : dependencies(std::move(collector)), path(depsFile), target(target)
+    {
+    }
+
+    virtual void HandleTranslationUnit(ASTContext& context)
+    {
+        std::error_code err;
+        llvm::raw_fd_ostream file(path, err, llvm::sys::fs::OF_Text);
+        if(err)
+        {
+            GenerateError(context, "Unable to open dependency file '%0': %1", path, err.message());
+            return;
+        }
+        WriteEscaped(file, target) << ':';
+        for(const auto& dependency : dependencies->getDependencies())
+        {
+            WriteEscaped(file << " \\\n  ", dependency);
+        }
+        file << '\n';
+    }
 
+private:
     /**
-     * Specifies the output directory to write XML documentation to (or empty to not write documentation)
+     * Write a file name escaped for use in a Makefile rule
      *
+     * @param os The stream to write to
+     * @param filename The file name to write
+     * @return The stream
      */
-    std::optional<std::string> doc;
+    static llvm::raw_ostream& WriteEscaped(llvm::raw_ostream& os, StringRef filename)
+    {
+        for(char c : filename)
+        {
+            if((c == ' ') || (c == '#'))
+            {
+                os << '\\';
+            }
+            else if(c == '$')
+            {
+                os << '$';
+            }
+            os << c;
+        }
+        return os;
+    }
 
-    /**
-     * Specifies whether to just extract a list of names (true) of classes marked with the [[godot::class]]
-     * attribute (can be used to generate list of XML documentation files which will be generated)
-     */
-    bool extractClassNames;
+    std::shared_ptr<HeaderDependencyCollector> dependencies;
+    std::string path;
+    std::string target;
+};
 
+/**
+ * Consumer which writes the statistics recorded while processing the header (see Statistics),
+ * once the translation unit has been parsed and traversed (so must be after the other consumers)
+ */
+class WriteStatisticsConsumer : public ASTConsumer
+{
 public:
-    GenerateExtensionInterface() : outputFile(), doc(), extractClassNames(false) {}
-
     /**
-     * Create the consumer for handling the AST
+     * Construct consumer to write the statistics file
      *
-     * @param compiler The compiler instance
-     * @param file The file to parse
-     * @return Pointer to a ExtractClassNamesConsumer (if extractClassNames is true),
-     *         ExtractInterfaceConsumer<ExtractDocVisitor> (if doc is non-empty), or
-     *         ExtractInterfaceConsumer<ExtractInterfaceVisitor> otherwise
+     * @param statsFile The statistics file to write
+     * @param header The header file being processed
      */
-    std::unique_ptr<ASTConsumer> CreateASTConsumer(CompilerInstance& compiler, StringRef file) override
+    WriteStatisticsConsumer(const std::string& statsFile, const std::string& header)
+        : path(statsFile), header(header)
+    {
+    }
+
+    virtual void HandleTranslationUnit(ASTContext& context)
     {
-        if(extractClassNames)
+        Statistics::Stop();
+        std::error_code err;
+        llvm::raw_fd_ostream file(path, err, llvm::sys::fs::OF_Text);
+        if(err)
         {
-            compiler.getPreprocessor().SetSuppressIncludeNotFoundError(true);
-            return std::make_unique<ExtractClassNamesConsumer>(&compiler.getASTContext());
+            GenerateError(context, "Unable to open statistics file '%0': %1", path, err.message());
+            return;
         }
-        std::unique_ptr<llvm::raw_pwrite_stream> outFile;
-        std::string header;
-        std::string funcName = "stdout";
-        if(file != "-")
+        Statistics::Write(file, header);
+    }
+
+private:
+    std::string path;
+    std::string header;
+};
+
+std::unique_ptr<ASTConsumer> GenerateExtensionInterface::CreateASTConsumer(CompilerInstance& compiler, StringRef file)
+{
+    // Started before parsing, so the attributes handled while parsing are recorded
+    if(statsFile && !extractClassNames)
+    {
+        Statistics::Start();
+    }
+    else
+    {
+        Statistics::Stop();
+    }
+    if(extractClassNames)
+    {
+        compiler.getPreprocessor().SetSuppressIncludeNotFoundError(true);
+        return std::make_unique<ExtractClassNamesConsumer>(&compiler.getASTContext(), fullTranslationUnit);
+    }
+    std::unique_ptr<llvm::raw_pwrite_stream> outFile;
+    std::string header;
+    std::string funcName = "stdout";
+    if(file != "-")
+    {
+        std::filesystem::path path(file.data());
+        if(!outputFile)
+        {
+            header = path.filename();
+            path.replace_extension(".gen.cpp");
+            outputFile = path.generic_string();
+        }
+        else
+        {
+            header = std::filesystem::relative(std::filesystem::absolute(path),
+                std::filesystem::absolute(*outputFile).parent_path());
+        }
+        funcName = path.stem().generic_string();
+        std::replace_if(funcName.begin(), funcName.end(), [](char c)
+            {
+                return ((c < '0') || (c > '9'))
+                    && ((c < 'a') || (c > 'z'))
+                    && ((c < 'A') || (c > 'Z'))
+                    && (c != '_');
+            }, '_');
+    }
+    if(outputFile && (*outputFile != "-"))
+    {
+        // Only written if changed, so the generated file is not recompiled when regenerated
+        outFile = std::make_unique<WriteIfChangedStream>(*outputFile, compiler.getDiagnostics());
+    }
+    else if(outputFile)
+    {
+        outFile = compiler.createOutputFile(*outputFile, false, true, true);
+    }
+    if(outFile)
+    {
+        if(!header.empty())
+        {
+            *outFile << "#include \"" << header << "\"\n\n";
+        }
+        *outFile << "#include <godot_cpp/core/class_db.hpp>\n\n";
+    }
+    auto& traits = compiler.getASTContext().getCommentCommandTraits();
+    traits.registerBlockCommand("tutorial");
+    traits.registerBlockCommand("experimental");
+    std::vector<std::unique_ptr<InterfaceSink>> sinks;
+    sinks.push_back(std::make_unique<ClassNamesSink>((classNames) ? *classNames : llvm::outs()));
+    if(manifestFile)
+    {
+        sinks.push_back(std::make_unique<ManifestSink>(
+            Manifest{*manifestFile, file.str(), outputFile.value_or(""), funcName, doc}));
+    }
+    if(interfaceFile)
+    {
+        sinks.push_back(std::make_unique<InterfaceDumpSink>(*interfaceFile, file.str()));
+    }
+    std::unique_ptr<ASTConsumer> consumer;
+    if(doc)
+    {
+        consumer = CreateInterfaceConsumer<ExtractDocVisitor>(std::move(sinks),
+            &compiler.getASTContext(), fullTranslationUnit, std::move(outFile), funcName, *doc, tables, thunks, docJobs, docBudget);
+    }
+    else
+    {
+        consumer = CreateInterfaceConsumer<ExtractInterfaceVisitor>(std::move(sinks),
+            &compiler.getASTContext(), fullTranslationUnit, std::move(outFile), funcName, tables, thunks);
+    }
+    if(!depsFile && !statsFile)
+    {
+        return consumer;
+    }
+    std::vector<std::unique_ptr<ASTConsumer>> consumers;
+    consumers.push_back(std::move(consumer));
+    if(depsFile)
+    {
+        // The preprocessor has already been created, so attach directly (adding to the compiler
+        // instance ensures any precompiled header inputs are also collected)
+        auto collector = std::make_shared<HeaderDependencyCollector>();
+        collector->attachToPreprocessor(compiler.getPreprocessor());
+        compiler.addDependencyCollector(collector);
+        consumers.push_back(std::make_unique<WriteDependenciesConsumer>(collector, *depsFile,
+            outputFile.value_or(std::string{file})));
+    }
+    if(statsFile)
+    {
+        consumers.push_back(std::make_unique<WriteStatisticsConsumer>(*statsFile, file.str()));
+    }
+    return std::make_unique<MultiplexConsumer>(std::move(consumers));
+}
+
+bool GenerateExtensionInterface::ParseArgs(const CompilerInstance& ci, const std::vector<std::string>& args)
+{
+    auto size = args.size();
+    for(unsigned int i = 0; i != size; ++i)
+    {
+        DiagnosticsEngine& diag = ci.getDiagnostics();
+        if(args[i] == "-out")
         {
-            std::filesystem::path path(file.data());
-            if(!outputFile)
+            ++i;
+            if(i != size)
             {
-                header = path.filename();
-                path.replace_extension(".gen.cpp");
-                outputFile = path.generic_string();
+                outputFile = args[i];
             }
             else
             {
-                header = std::filesystem::relative(std::filesystem::absolute(path),
-                    std::filesystem::absolute(*outputFile).parent_path());
+                diag.Report(diag.getCustomDiagID(DiagnosticsEngine::Error,
+                    "missing -out argument"));
+                return false;
             }
-            funcName = path.stem().generic_string();
-            std::replace_if(funcName.begin(), funcName.end(), [](char c)
-                {
-                    return ((c < '0') || (c > '9'))
-                        && ((c < 'a') || (c > 'z'))
-                        && ((c < 'A') || (c > 'Z'))
-                        && (c != '_');
-                }, '_');
         }
-        if(outputFile)
+        else if(args[i] == "-doc")
         {
-            outFile = compiler.createOutputFile(*outputFile, false, true, true);
+            ++i;
+            if(i != size)
+            {
+                doc = args[i];
+            }
+            else
+            {
+                diag.Report(diag.getCustomDiagID(DiagnosticsEngine::Error,
+                    "missing -doc argument"));
+                return false;
+            }
         }
-        if(outFile)
+        else if(args[i] == "-deps")
         {
-            if(!header.empty())
+            ++i;
+            if(i != size)
             {
-                *outFile << "#include \"" << header << "\"\n\n";
+                depsFile = args[i];
+            }
+            else
+            {
+                diag.Report(diag.getCustomDiagID(DiagnosticsEngine::Error,
+                    "missing -deps argument"));
+                return false;
             }
-            *outFile << "#include <godot_cpp/core/class_db.hpp>\n\n";
         }
-        auto& traits = compiler.getASTContext().getCommentCommandTraits();
-        traits.registerBlockCommand("tutorial");
-        traits.registerBlockCommand("experimental");
-        if(doc)
+        else if(args[i] == "-manifest")
         {
-            return std::make_unique<ExtractInterfaceConsumer<ExtractDocVisitor>>(
-                &compiler.getASTContext(), std::move(outFile), funcName, *doc);
+            ++i;
+            if(i != size)
+            {
+                manifestFile = args[i];
+            }
+            else
+            {
+                diag.Report(diag.getCustomDiagID(DiagnosticsEngine::Error,
+                    "missing -manifest argument"));
+                return false;
+            }
         }
-        else
+        else if(args[i] == "-interface")
         {
-            return std::make_unique<ExtractInterfaceConsumer<ExtractInterfaceVisitor>>(
-                &compiler.getASTContext(), std::move(outFile), funcName);
+            ++i;
+            if(i != size)
+            {
+                interfaceFile = args[i];
+            }
+            else
+            {
+                diag.Report(diag.getCustomDiagID(DiagnosticsEngine::Error,
+                    "missing -interface argument"));
+                return false;
+            }
         }
-    }
-
-    /**
-     * Parse the plugin's argument list
-     *
-     * @param ci The compiler instance
-     * @param args The arguments to parse
-     * @return true
-     */
-    bool ParseArgs(const CompilerInstance& ci, const std::vector<std::string>& args) override
-    {
-        auto size = args.size();
-        for(unsigned int i = 0; i != size; ++i)
+        else if(args[i] == "-stats")
         {
-            DiagnosticsEngine& diag = ci.getDiagnostics();
-            if(args[i] == "-out")
+            ++i;
+            if(i != size)
             {
-                ++i;
-                if(i != size)
-                {
-                    outputFile = args[i];
-                }
-                else
-                {
-                    diag.Report(diag.getCustomDiagID(DiagnosticsEngine::Error,
-                        "missing -out argument"));
-                    return false;
-                }
+                statsFile = args[i];
             }
-            else if(args[i] == "-doc")
+            else
             {
-                ++i;
-                if(i != size)
-                {
-                    doc = args[i];
-                }
-                else
-                {
-                    diag.Report(diag.getCustomDiagID(DiagnosticsEngine::Error,
-                        "missing -doc argument"));
-                    return false;
-                }
+                diag.Report(diag.getCustomDiagID(DiagnosticsEngine::Error,
+                    "missing -stats argument"));
+                return false;
             }
-            else if(args[i] == "-nameonly")
+        }
+        else if(args[i] == "-doc-jobs")
+        {
+            ++i;
+            if((i == size) || StringRef(args[i]).getAsInteger(10, docJobs))
             {
-                extractClassNames = true;
+                diag.Report(diag.getCustomDiagID(DiagnosticsEngine::Error,
+                    "missing or invalid -doc-jobs argument"));
+                return false;
             }
         }
-        return true;
-    }
-
-    PluginASTAction::ActionType getActionType() override
-    {
-        return PluginASTAction::AddBeforeMainAction;
+        else if(args[i] == "-doc-budget")
+        {
+            ++i;
+            std::size_t budget;
+            if((i == size) || StringRef(args[i]).getAsInteger(10, budget))
+            {
+                diag.Report(diag.getCustomDiagID(DiagnosticsEngine::Error,
+                    "missing or invalid -doc-budget argument"));
+                return false;
+            }
+            docBudget = budget;
+        }
+        else if(args[i] == "-nameonly")
+        {
+            extractClassNames = true;
+        }
+        else if(args[i] == "-full-tu")
+        {
+            fullTranslationUnit = true;
+        }
+        else if(args[i] == "-tables")
+        {
+            tables = true;
+        }
+        else if(args[i] == "-thunks")
+        {
+            thunks = true;
+        }
     }
-};
+    return true;
+}
 
 /**
  * Registers the plugin
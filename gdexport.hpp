@@ -0,0 +1,191 @@
+// SPDX-FileCopyrightText: 2025 Gridshadows Gaming <https://www.gridshadows.co.uk>
+// SPDX-License-Identifier: Zlib
+
+#ifndef GDEXPORT_GDEXPORT_HPP
+#define GDEXPORT_GDEXPORT_HPP
+
+#include "clang/AST/ASTConsumer.h"
+#include "clang/Frontend/CompilerInstance.h"
+#include "clang/Frontend/FrontendAction.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <optional>
+#include <string>
+#include <vector>
+
+using namespace clang;
+
+/**
+ * Clang plugin for parsing the godot attributes and generating the export code.
+ *
+ * Can also be run as the main frontend action (see batch.cpp), in which case the arguments are
+ * passed to the constructor rather than parsed from the plugin arguments.
+ */
+class GenerateExtensionInterface : public PluginASTAction
+{
+    // Hack: for some reason if these are just std::string clang crashes!
+
+    /**
+     * Specifies the output file to write the generated code to (or empty for automatic name deduction)
+     */
+    std::optional<std::string> outputFile;
+
+    /**
+     * Specifies the output directory to write XML documentation to (or empty to not write documentation)
+     *
+     */
+    std::optional<std::string> doc;
+
+    /**
+     * Specifies whether to just extract a list of names (true) of classes marked with the [[godot::class]]
+     * attribute (can be used to generate list of XML documentation files which will be generated)
+     */
+    bool extractClassNames;
+
+    /**
+     * Specifies whether to traverse the whole translation unit (true), rather than just the
+     * top-level declarations in the main file
+     */
+    bool fullTranslationUnit;
+
+    /**
+     * Specifies the Makefile-style dependency file to write the list of files the header depends
+     * on to (or empty to not write a dependency file)
+     */
+    std::optional<std::string> depsFile;
+
+    /**
+     * Specifies the file to write the manifest (JSON list of the generated files and exported
+     * classes) to (or empty to not write a manifest)
+     */
+    std::optional<std::string> manifestFile;
+
+    /**
+     * Specifies the file to write the dump of the exported interface to (binary, or JSON if the
+     * file has a `.json` extension; see InterfaceDumpSink), or empty to not write a dump
+     */
+    std::optional<std::string> interfaceFile;
+
+    /**
+     * Specifies whether to register the properties and signals from constant tables, rather than
+     * a separate call for each
+     */
+    bool tables;
+
+    /**
+     * Specifies whether to bind the methods with generated call and ptrcall functions, rather
+     * than godot-cpp's MethodBind templates
+     */
+    bool thunks;
+
+    /**
+     * Specifies the number of threads to write the XML documentation files with once the
+     * translation unit has been parsed (or 0 to write each file while traversing the AST)
+     */
+    unsigned int docJobs;
+
+    /**
+     * Specifies the number of bytes of rendered XML documentation to hold in memory, streaming the
+     * documentation to temporary files beyond it (or empty to keep the parsed documentation of each
+     * class in memory until the class is written)
+     */
+    std::optional<std::size_t> docBudget;
+
+    /**
+     * Specifies the file to write the statistics (JSON counts of, and time spent in, each phase of
+     * processing the header) to (or empty to not record statistics)
+     */
+    std::optional<std::string> statsFile;
+
+    /**
+     * The stream to print the names of the classes for which documentation is generated to (or
+     * null for stdout)
+     */
+    llvm::raw_ostream* classNames;
+
+public:
+    GenerateExtensionInterface()
+        : outputFile(), doc(), extractClassNames(false), fullTranslationUnit(false), depsFile(), manifestFile(),
+          interfaceFile(), tables(false), thunks(false), docJobs(0), docBudget(), statsFile(), classNames(nullptr)
+    {
+    }
+
+    /**
+     * Create the action with the arguments already specified
+     *
+     * @param output The output file to write the generated code to
+     * @param documentation The output directory to write XML documentation to (or empty to not
+     *                      write documentation)
+     * @param dependencies The dependency file to write (or empty to not write a dependency file)
+     * @param manifest The manifest file to write (or empty to not write a manifest)
+     * @param useTables true to register the properties and signals from constant tables
+     * @param useThunks true to bind the methods with generated call and ptrcall functions
+     * @param documentationJobs The number of threads to write the XML documentation files with
+     *                          (or 0 to write each file while traversing the AST)
+     * @param statistics The statistics file to write (or empty to not record statistics)
+     * @param documentationBudget The number of bytes of XML documentation to hold in memory (or
+     *                            empty to not stream the documentation)
+     * @param interfaceDump The dump of the exported interface to write (or empty to not write a dump)
+     */
+    GenerateExtensionInterface(const std::string& output, const std::optional<std::string>& documentation,
+            const std::optional<std::string>& dependencies, const std::optional<std::string>& manifest,
+            bool useTables = false, bool useThunks = false, unsigned int documentationJobs = 0,
+            const std::optional<std::string>& statistics = std::nullopt,
+            std::optional<std::size_t> documentationBudget = std::nullopt,
+            const std::optional<std::string>& interfaceDump = std::nullopt)
+        : outputFile(output)
+        , doc(documentation)
+        , extractClassNames(false)
+        , fullTranslationUnit(false)
+        , depsFile(dependencies)
+        , manifestFile(manifest)
+        , interfaceFile(interfaceDump)
+        , tables(useTables)
+        , thunks(useThunks)
+        , docJobs(documentationJobs)
+        , docBudget(documentationBudget)
+        , statsFile(statistics)
+        , classNames(nullptr)
+    {
+    }
+
+    /**
+     * Set the stream to print the names of the exported classes to, rather than stdout (e.g., so
+     * the names for headers processed in parallel are not interleaved)
+     *
+     * @param os The stream (which must outlive the action)
+     */
+    void SetClassNamesStream(llvm::raw_ostream& os)
+    {
+        classNames = &os;
+    }
+
+    /**
+     * Create the consumer for handling the AST
+     *
+     * @param compiler The compiler instance
+     * @param file The file to parse
+     * @return Pointer to a ExtractClassNamesConsumer (if extractClassNames is true),
+     *         ExtractInterfaceConsumer<ExtractDocVisitor> (if doc is non-empty), or
+     *         ExtractInterfaceConsumer<ExtractInterfaceVisitor> otherwise (with sinks for the
+     *         class list and manifest, which share the traversal of the AST), followed by
+     *         consumers to write the dependency and statistics files (if specified)
+     */
+    std::unique_ptr<ASTConsumer> CreateASTConsumer(CompilerInstance& compiler, StringRef file) override;
+
+    /**
+     * Parse the plugin's argument list
+     *
+     * @param ci The compiler instance
+     * @param args The arguments to parse
+     * @return true
+     */
+    bool ParseArgs(const CompilerInstance& ci, const std::vector<std::string>& args) override;
+
+    PluginASTAction::ActionType getActionType() override
+    {
+        return PluginASTAction::AddBeforeMainAction;
+    }
+};
+
+#endif // GDEXPORT_GDEXPORT_HPP
@@ -26,6 +26,40 @@ import pathlib
 import os
 from importlib import resources
 import platform
+import hashlib
+import json
+import shutil
+import tempfile
+import threading
+import atexit
+import contextlib
+import functools
+import io
+import struct
+from concurrent.futures import ThreadPoolExecutor
+
+_resources = contextlib.ExitStack()
+"""
+Keeps the resource files (plugin and batch driver) available on the file system for the lifetime
+of the process, so they are only extracted once if the package is not on the file system
+"""
+atexit.register(_resources.close)
+
+@functools.lru_cache(maxsize=None)
+def _resource_file(name : str) -> pathlib.Path:
+    """
+    Gets the path to a resource file in the `lib` folder, which remains valid for the lifetime of
+    the process
+
+    :param str name: The name of the resource file
+
+    :return: The path to the resource file
+    """
+    if __package__ is None:
+        resource = resources.files("lib") / name
+    else:
+        resource = resources.files(__package__) / "lib" / name
+    return _resources.enter_context(resources.as_file(resource))
 
 def _get_plugin_path():
     """
@@ -46,10 +80,20 @@ def _get_plugin_path():
             gdexport_plugin_lib = 'gdexport.dll'
         case _:
             gdexport_plugin_lib = 'libgdexport.so'
-    if __package__ is None:
-        return resources.as_file(resources.files("lib") / gdexport_plugin_lib)
-    else:
-        return resources.as_file(resources.files(__package__) / "lib" / gdexport_plugin_lib)
+    return contextlib.nullcontext(_resource_file(gdexport_plugin_lib))
+
+def _get_batch_path():
+    """
+    Gets a context manager object for the resource file for the batch driver
+    (`gdexport-batch`), which processes several header files in one process:
+
+    ```
+    with _get_batch_path() as batch:
+        # 'batch' is now the path to the batch driver
+    ```
+    """
+    gdexport_batch_exe = 'gdexport-batch.exe' if platform.system() == "Windows" else 'gdexport-batch'
+    return contextlib.nullcontext(_resource_file(gdexport_batch_exe))
 
 def _dest_folder(folder : str|None, create_folders : bool, desc : str) -> pathlib.Path|None:
     """
@@ -82,6 +126,20 @@ def validate_name(name : str):
     """
     return re.match('^[a-zA-Z_][a-zA-Z0-9_]*$', name) is not None
 
+@functools.lru_cache(maxsize=None)
+def _clang_version_output(clang : str) -> subprocess.CompletedProcess:
+    """
+    Runs `clang --version`. The result is cached for the lifetime of the process, so clang is
+    only run once for each executable
+
+    :param str clang: Path (relative, absolute, or exe name in PATH) to the clang executable
+
+    :raises subprocess.CalledProcessError: if an error occurs when calling `clang`
+
+    :return: The completed process (with `stdout` and `stderr` as strings)
+    """
+    return subprocess.run([str(clang), "--version"], capture_output=True, encoding="utf-8", check=True)
+
 def _check_clang_version(clang : str):
     """
     Check if the specified path actually points to a valid version of clang
@@ -94,7 +152,7 @@ def _check_clang_version(clang : str):
 
     :return: The version number of the specified clang executable
     """
-    check_version = subprocess.run([str(clang), "--version"], capture_output=True, encoding="utf-8", check=True)
+    check_version = _clang_version_output(str(clang))
     version = re.search(r"clang.*?(([0-9]+)((?:[.](?:[0-9]+))*))", check_version.stdout)
     if not version:
         raise subprocess.CalledProcessError(0, "clang --version", check_version.stdout,
@@ -109,8 +167,10 @@ def _load_godot_paths(godot : str|None, sysincludes : list[str]) -> list[str]:
     :param str|None godot:         Path to `godot-cpp` folder to deduce include paths from
     :param list[str]) sysincludes: Current list of `sysincludes` to add include paths to
 
-    :return: The modified `sysincludes` list
+    :return: The `sysincludes` list with the `godot-cpp` include paths added (a new list, so that
+             the list passed as argument, which may be a default argument, is not modified)
     """
+    sysincludes = list(sysincludes)
     if godot:
         godot_path = pathlib.Path(str(godot))
         sysincludes.append(str(godot_path / "gdextension"))
@@ -123,7 +183,11 @@ def _load_arguments(clang          : str,
                     sysincludes    : list[str],
                     includes       : list[str],
                     documentation  : str|None,
-                    args           : list[str]) -> list[str]:
+                    args           : list[str],
+                    tables         : bool = False,
+                    thunks         : bool = False,
+                    doc_jobs       : int  = 0,
+                    doc_budget     : int|None = None) -> list[str]:
     """
     Generates the argument list for calling clang with the plugin to process a header file
 
@@ -136,30 +200,864 @@ def _load_arguments(clang          : str,
     :param str|None documentation: Specify whether to also extract Doxygen style comments from the
                                    C++ source and generate the Godot XML documentation for the extension.
     :param list[str] args:         List of extra command line arguments to pass to clang
+    :param bool tables:            Specifies whether the plugin registers properties and signals
+                                   from constant tables (see `generate_all`)
+    :param bool thunks:            Specifies whether the plugin binds methods with generated call and
+                                   ptrcall functions (see `generate_all`)
+    :param int doc_jobs:           Number of threads the plugin writes the XML documentation files
+                                   with (see `generate_all`)
+    :param int|None doc_budget:    Number of bytes of XML documentation the plugin holds in memory
+                                   (see `generate_all`), or None
 
     :return: List of arguments (strings) to pass to `subprocess` run methods to run clang. The last
              two arguments of the returned array will be the empty string and should be replaced with
              the output and input file paths, respectively, for the header file to process
     """
+    arguments = _compile_arguments(clang, sysincludes, includes, args)
+    arguments.append("-fplugin="+str(plugin))
+    if documentation:
+        arguments += _plugin_arguments("-doc", str(documentation))
+        if doc_jobs > 0:
+            arguments += _plugin_arguments("-doc-jobs", str(doc_jobs))
+        if doc_budget is not None:
+            arguments += _plugin_arguments("-doc-budget", str(doc_budget))
+    if tables:
+        arguments += _plugin_arguments("-tables")
+    if thunks:
+        arguments += _plugin_arguments("-thunks")
+    arguments += _plugin_arguments("-out", "")
+    arguments.append("")
+    return arguments
+
+def _compile_arguments(clang       : str,
+                       sysincludes : list[str],
+                       includes    : list[str],
+                       args        : list[str]) -> list[str]:
+    """
+    Generates the argument list for calling clang to parse a header file, without the plugin
+    arguments or the header file
+
+    :param str clang:             Path (relative, absolute, or exe name in PATH) to the clang executable
+    :param list[str] sysincludes: List of paths to treat as system include directories;
+                                  i.e., `-isystem` paths to Clang
+    :param list[str] includes:    List of paths to treat as normal include directories;
+                                  i.e., `-I` paths to Clang
+    :param list[str] args:        List of extra command line arguments to pass to clang
+
+    :return: List of arguments (strings) to pass to clang
+    """
     arguments = [str(clang), "-fsyntax-only", "-Xclang", "-std=c++17",
-                 "-Xclang", "-DGDEXPORT_GENERATING", "-fplugin="+str(plugin)]
+                 "-Xclang", "-DGDEXPORT_GENERATING"]
     for inc in sysincludes:
         arguments += ["-Xclang", "-isystem", "-Xclang", str(inc)]
     for inc in includes:
         arguments += ["-Xclang", "-I", "-Xclang", str(inc)]
     arguments += [y for x in args for y in ("-Xclang", str(x))]
-    if documentation:
-        arguments += [
-            "-Xclang", "-plugin-arg-gdexport", "-Xclang", "-doc",
-            "-Xclang", "-plugin-arg-gdexport", "-Xclang", str(documentation)
-        ]
-    arguments += [
-        "-Xclang", "-plugin-arg-gdexport", "-Xclang", "-out",
-        "-Xclang", "-plugin-arg-gdexport", "-Xclang", ""
-    ]
-    arguments.append("")
     return arguments
 
+def _batch_arguments(clang       : str,
+                     sysincludes : list[str],
+                     includes    : list[str],
+                     args        : list[str]) -> list[str]:
+    """
+    Generates the clang argument list to pass to the batch driver. As the batch driver is not
+    installed alongside clang, it is passed the resource directory of the specified clang, so the
+    compiler's built-in headers are found
+
+    :param str clang:             Path (relative, absolute, or exe name in PATH) to the clang executable
+    :param list[str] sysincludes: List of paths to treat as system include directories;
+                                  i.e., `-isystem` paths to Clang
+    :param list[str] includes:    List of paths to treat as normal include directories;
+                                  i.e., `-I` paths to Clang
+    :param list[str] args:        List of extra command line arguments to pass to clang
+
+    :raises subprocess.CalledProcessError: if the return from `clang -print-resource-dir` is invalid
+
+    :return: List of arguments (strings) to pass to the batch driver after `--`
+    """
+    return _compile_arguments(clang, sysincludes, includes, args) + ["-resource-dir", _resource_dir(str(clang))]
+
+@functools.lru_cache(maxsize=None)
+def _resource_dir(clang : str) -> str:
+    """
+    Gets the resource directory (containing the compiler's built-in headers) of a clang executable.
+    The result is cached for the lifetime of the process
+
+    :param str clang: Path (relative, absolute, or exe name in PATH) to the clang executable
+
+    :raises subprocess.CalledProcessError: if an error occurs when calling `clang`
+
+    :return: The resource directory
+    """
+    return subprocess.run([str(clang), "-print-resource-dir"], capture_output=True,
+                          encoding="utf-8", check=True).stdout.strip()
+
+def _plugin_arguments(*values : str) -> list[str]:
+    """
+    Generates the clang arguments for passing the specified arguments to the plugin
+
+    :param str values: The arguments to pass to the plugin
+
+    :return: List of arguments to pass to clang
+    """
+    return [y for x in values for y in ("-Xclang", "-plugin-arg-gdexport", "-Xclang", str(x))]
+
+def _jobs_argument(value : str) -> int:
+    """
+    Parses the value of the `--jobs` command line option
+
+    :param str value: The number of jobs, or `auto` for the number of CPUs
+
+    :raises argparse.ArgumentTypeError: if the value is not `auto` or an integer
+
+    :return: The number of jobs; 0 for the number of CPUs (see `_job_count`)
+    """
+    if value == "auto":
+        return 0
+    try:
+        return int(value)
+    except ValueError:
+        import argparse
+        raise argparse.ArgumentTypeError("invalid number of jobs: '{}' (expected N or 'auto')".format(value))
+
+def _folder_argument(value : str) -> str:
+    """
+    Parses the value of the `--cache`, `--pch` and `--modules` command line options
+
+    :param str value: The folder, or `default` for the default folder of the option
+
+    :return: The folder; the empty string for the default folder
+    """
+    return "" if value == "default" else value
+
+def _job_count(jobs : int|None) -> int:
+    """
+    Gets the number of worker threads to use to run clang
+
+    :param int|None jobs: The requested number of jobs; `None` or a value less than 1 to use
+                          the number of CPUs
+
+    :return: The number of worker threads to use (always at least 1)
+    """
+    if jobs is None or jobs < 1:
+        return os.cpu_count() or 1
+    return jobs
+
+def _manifest_path(output : str) -> str:
+    """
+    Gets the path to the manifest written alongside a generated C++ source file; i.e., `<name>.gen.json`
+    for `<name>.gen.cpp`. The manifest is a JSON file listing the generated files and the exported classes.
+
+    :param str output: The generated C++ source file
+
+    :return: The path to the manifest
+    """
+    return str(pathlib.Path(str(output)).with_suffix(".json"))
+
+def _stats_path(output : str) -> str:
+    """
+    Gets the path to the statistics written alongside a generated C++ source file (if requested);
+    i.e., `<name>.gen.stats.json` for `<name>.gen.cpp`. The statistics are a JSON file containing the
+    time spent processing the header, and the number of times each phase of the plugin was entered
+    and the time spent in it.
+
+    :param str output: The generated C++ source file
+
+    :return: The path to the statistics
+    """
+    return str(pathlib.Path(str(output)).with_suffix(".stats.json"))
+
+def _interface_path(output : str) -> str:
+    """
+    Gets the path to the interface dump written alongside a generated C++ source file (if
+    requested); i.e., `<name>.gen.interface` for `<name>.gen.cpp` (see `read_interface`).
+
+    :param str output: The generated C++ source file
+
+    :return: The path to the interface dump
+    """
+    return str(pathlib.Path(str(output)).with_suffix(".interface"))
+
+def _print_stats(headers : list[tuple[str,str]]):
+    """
+    Prints a summary table of the statistics written by the plugin for each header file, slowest
+    header first. Headers without statistics (e.g., restored from the cache) are not listed
+
+    :param list[tuple[str,str]] headers: The header files, and the generated C++ source file for each
+    """
+    rows = []
+    for file,output in headers:
+        try:
+            with open(_stats_path(output), encoding='utf-8') as f:
+                rows.append((file, json.load(f)))
+        except (OSError, ValueError):
+            pass
+    if not rows:
+        return
+    phases = list(rows[0][1]["phases"].keys())
+    rows.sort(key=lambda x: x[1]["seconds"], reverse=True)
+    width = max(len("header"), max(len(x[0]) for x in rows))
+    print("{:<{}}  {:>9}".format("header", width, "total (s)")
+          + "".join("  {:>20}".format(x+" (s/#)") for x in phases)
+          + "  {:>15}".format("peak heap (MiB)"))
+    for file,data in rows + [("total", None)]:
+        if data is None:
+            # The peak memory of the headers is the largest peak (not the sum)
+            data = { "seconds": sum(x[1]["seconds"] for x in rows),
+                     "phases": { phase : { y : sum(x[1]["phases"][phase][y] for x in rows)
+                                           for y in ["seconds", "count"] } for phase in phases },
+                     "memory": { "peak_heap_bytes": max(x[1].get("memory", {}).get("peak_heap_bytes", 0)
+                                                        for x in rows) } }
+        print("{:<{}}  {:>9.3f}".format(file, width, data["seconds"])
+              + "".join("  {:>11.3f} /{:>7}".format(data["phases"][x]["seconds"], data["phases"][x]["count"])
+                        for x in phases)
+              + "  {:>15.1f}".format(data.get("memory", {}).get("peak_heap_bytes", 0) / (1024 * 1024)))
+
+def _read_manifest(output : str, file : str) -> dict|None:
+    """
+    Reads the manifest written when generating a C++ source file, if it is up-to-date with the
+    header file it was generated from
+
+    :param str output: The generated C++ source file
+    :param str file:   The header file the C++ source file is generated from
+
+    :return: The content of the manifest, or None if there is no manifest or the header file has changed
+    """
+    try:
+        with open(_manifest_path(output), encoding='utf-8') as f:
+            manifest = json.load(f)
+    except (OSError, ValueError):
+        return None
+    if manifest.get("header_sha256") != _hash_file(file):
+        return None
+    return manifest
+
+def _hash_file(path : str|pathlib.Path) -> str|None:
+    """
+    Gets the SHA-256 hash of the content of a file
+
+    :param str|pathlib.Path path: Path to the file to hash
+
+    :return: The hash as a hexadecimal string, or None if the file could not be read
+    """
+    digest = hashlib.sha256()
+    try:
+        with open(str(path), 'rb') as f:
+            for block in iter(lambda: f.read(1 << 20), b''):
+                digest.update(block)
+    except OSError:
+        return None
+    return digest.hexdigest()
+
+def _hash_binary(path : pathlib.Path) -> str|None:
+    """
+    Gets the SHA-256 hash of the content of the plugin or batch driver, only reading the file again
+    if its modification time or size has changed
+
+    :param pathlib.Path path: Path to the file to hash
+
+    :return: The hash as a hexadecimal string, or None if the file could not be read
+    """
+    try:
+        stat = os.stat(str(path))
+    except OSError:
+        return None
+    return _hash_binary_version(str(path), stat.st_mtime_ns, stat.st_size)
+
+def _binary_version(path : pathlib.Path) -> str:
+    """
+    Identifies the version of a file by its absolute path, modification time and size (used when
+    the file cannot be hashed)
+
+    :param pathlib.Path path: Path to the file
+
+    :return: The version as a string
+    """
+    try:
+        stat = os.stat(str(path))
+        return "{}:{}:{}".format(os.path.abspath(str(path)), stat.st_mtime_ns, stat.st_size)
+    except OSError:
+        return os.path.abspath(str(path))
+
+@functools.lru_cache(maxsize=None)
+def _hash_binary_version(path : str, mtime : int, size : int) -> str|None:
+    """
+    Gets the SHA-256 hash of a version of a file (see `_hash_binary`)
+    """
+    return _hash_file(path)
+
+def _parse_dependency_file(path : str|pathlib.Path) -> list[str]:
+    """
+    Parses the Makefile-style dependency file written by the plugin (`-deps` argument)
+
+    :param str|pathlib.Path path: Path to the dependency file
+
+    :return: List of the files the rule in the dependency file depends on
+    """
+    with open(str(path), encoding='utf-8') as f:
+        content = f.read().replace('\\\n', ' ')
+    _, _, dependencies = content.partition(': ')
+    return [re.sub(r'\\([ #])', r'\1', x).replace('$$', '$')
+            for x in re.findall(r'(?:\\[ #]|\S)+', dependencies)]
+
+def _dependency_path(output : str) -> str:
+    """
+    Gets the path to the dependency file written alongside a generated C++ source file (if
+    requested); i.e., `<name>.gen.d` for `<name>.gen.cpp`
+
+    :param str output: The generated C++ source file
+
+    :return: The path to the dependency file
+    """
+    return str(pathlib.Path(str(output)).with_suffix(".d"))
+
+def _write_dependency_file(path : str, target : str, dependencies : list[str]):
+    """
+    Writes a Makefile-style dependency file, in the same format as the plugin (`-deps` argument)
+
+    :param str path:               Path to the dependency file
+    :param str target:             The target of the rule in the dependency file (the generated file)
+    :param list[str] dependencies: The files the target depends on
+    """
+    def escape(name : str) -> str:
+        return re.sub(r'([ #])', r'\\\1', name).replace('$', '$$')
+
+    with open(path, 'w', encoding='utf-8') as f:
+        f.write(escape(target) + ':' + ''.join(' \\\n  ' + escape(x) for x in dependencies) + '\n')
+
+def header_dependencies(output : str) -> list[str]:
+    """
+    Gets the files a generated C++ source file depends on, from the dependency file written when
+    it was generated (see the `dependencies` argument of `export_header`); i.e., the header file
+    and every file included when processing it
+
+    :param str output: The generated C++ source file
+
+    :return: List of the files the generated file depends on, or an empty list if there is no
+             dependency file (e.g., the file has not been generated yet)
+    """
+    try:
+        return _parse_dependency_file(_dependency_path(output))
+    except OSError:
+        return []
+
+_GODOT_ATTRIBUTES = ["method", "signal", "getter", "setter", "group", "subgroup",
+                     "tool", "class", "enum", "bitfield", "constants"]
+"""
+The names of the attributes registered by the plugin (see attributes.cpp), each of which can be
+spelt `godot::<name>` or `godot_<name>`
+"""
+
+_SOURCE_SKIP = re.compile(r'//[^\n]*'
+                          r'|/\*.*?\*/'
+                          r'|R"([^()\\\s]{0,16})\(.*?\)\1"'
+                          r'|"(?:\\.|[^"\\\n])*"'
+                          r"|(?<![0-9A-Za-z_])'(?:\\.|[^'\\\n])*'", re.S)
+"""
+Comments, and string and character literals, in C++ source, which cannot contain an attribute
+"""
+
+_GODOT_ATTRIBUTE = re.compile(r'\bgodot\s*::\s*(?:{0})\b|\bgodot_(?:{0})\b|\busing\s+godot\s*:(?!:)'
+                              .format("|".join(_GODOT_ATTRIBUTES)))
+"""
+Any spelling of a godot attribute, or an attribute list with a `using godot:` prefix
+"""
+
+def _has_godot_attributes(file : str) -> bool:
+    """
+    Checks whether a header file may contain any godot attributes, by only lexing the header file
+    (removing comments and literals) rather than parsing it with clang. Attributes added by macros
+    defined in other files are not found.
+
+    :param str file: The header file to check
+
+    :return: False if the header file does not contain any godot attributes; True otherwise
+             (including if the header file could not be read)
+    """
+    try:
+        with open(str(file), encoding='utf-8', errors='replace') as f:
+            content = f.read()
+    except OSError:
+        return True
+    return _GODOT_ATTRIBUTE.search(_SOURCE_SKIP.sub(' ', content)) is not None
+
+def _write_if_changed(path : str, data : bytes):
+    """
+    Writes a file, only if the content differs from the existing file; so the modification time of
+    an unchanged file is preserved, and build systems do not recompile it. The content is written
+    to a temporary file which replaces the file once complete
+
+    :param str path:   The file to write
+    :param bytes data: The content of the file
+    """
+    try:
+        with open(path, 'rb') as f:
+            if f.read() == data:
+                return
+    except OSError:
+        pass
+    # Created with os.open (rather than tempfile), so the file has the default permissions
+    temporary = "{}.{}.{}.tmp".format(path, os.getpid(), threading.get_ident())
+    try:
+        with os.fdopen(os.open(temporary, os.O_WRONLY | os.O_CREAT | os.O_TRUNC, 0o666), 'wb') as f:
+            f.write(data)
+        os.replace(temporary, path)
+    except OSError:
+        pathlib.Path(temporary).unlink(missing_ok=True)
+        raise
+
+def _copy_if_changed(source : str, destination : str):
+    """
+    Copies a file, only if the content differs from the existing destination file (see `_write_if_changed`)
+
+    :param str source:      The file to copy
+    :param str destination: The file to copy to
+    """
+    with open(source, 'rb') as f:
+        _write_if_changed(destination, f.read())
+
+@contextlib.contextmanager
+def _open_if_changed(path : str):
+    """
+    Gets a context manager object for a text stream (as `open(path, 'w')`), which is written to the
+    file at the end of the context only if the content has changed (see `_write_if_changed`)
+
+    :param str path: The file to write
+    """
+    buffer = io.StringIO()
+    yield buffer
+    _write_if_changed(path, buffer.getvalue().replace('\n', os.linesep).encode('utf-8'))
+
+def _write_stub(file          : str,
+                output        : str,
+                documentation : pathlib.Path|None) -> tuple[str,list[str]|None]:
+    """
+    Writes the generated C++ source file (and manifest) for a header file without any godot
+    attributes, without running clang; i.e., an empty `initialize_<name>()` function
+
+    :param str file:   The header file
+    :param str output: The C++ source file to generate
+    :param pathlib.Path|None documentation: Path to documentation output folder, or None for no doc output
+
+    :return: The same as `_export_header`
+    """
+    identifier = re.sub("[^a-zA-Z0-9_]", '_', pathlib.Path(str(file)).stem)
+    with _open_if_changed(str(output)) as f:
+        f.write(('// Export: initialize_{0} ====================\n'
+                 'void initialize_{0}()\n'
+                 '{{\n'
+                 '}}\n').format(identifier))
+    with open(_manifest_path(output), 'w', encoding='utf-8') as f:
+        json.dump({"version": 1, "header": str(file), "header_sha256": _hash_file(file),
+                   "output": str(output), "bindings": 0, "classes": []}, f, indent=2)
+        f.write('\n')
+    return str(output),([] if documentation else None)
+
+class _HeaderCache:
+    """
+    On-disk cache of the files generated for a header file. Entries are keyed on the plugin binary
+    (and the clang executable running it), the arguments passed to clang and the content of the
+    header; and are only valid while the content of every file included when the header was last
+    processed is unchanged.
+    """
+
+    def __init__(self, folder : pathlib.Path, plugin : pathlib.Path, clang : str|None = None):
+        """
+        Creates the cache
+
+        :param pathlib.Path folder: The folder to store the cache entries in
+        :param pathlib.Path plugin: Path to the plugin (or batch driver, which links clang) for gdexport
+        :param str|None clang:      Path to the clang executable loading the plugin, or None for the
+                                    batch driver
+        """
+        self.folder = folder
+        # The path and modification time if the binary cannot be read, so an upgraded binary never
+        # restores entries generated by the previous version
+        self.plugin = _hash_binary(plugin) or _binary_version(plugin)
+        if clang:
+            self.plugin += '\0' + _clang_version_output(str(clang)).stdout
+        self.hashes = {}
+
+    def hash(self, path : str) -> str|None:
+        """
+        Gets the hash of a file, only reading each file once for the lifetime of the cache object
+
+        :param str path: Path to the file to hash
+
+        :return: The hash of the file content, or None if the file could not be read
+        """
+        if path not in self.hashes:
+            self.hashes[path] = _hash_file(path)
+        return self.hashes[path]
+
+    def key(self, arguments : list[str]) -> str:
+        """
+        Gets the key for the cache entry for processing a header file
+
+        :param list[str] arguments: The arguments to pass to clang to process the header file
+
+        :return: The key, as a hexadecimal string
+        """
+        digest = hashlib.sha256(self.plugin.encode('utf-8'))
+        for arg in arguments:
+            digest.update(arg.encode('utf-8') + b'\0')
+        digest.update((self.hash(arguments[-1]) or '').encode('utf-8'))
+        return digest.hexdigest()
+
+    def entry(self, key : str) -> pathlib.Path:
+        """
+        Gets the folder containing the cache entry with the specified key
+        """
+        return self.folder / key[:2] / key
+
+    def restore(self, key : str, output : str,
+                documentation : pathlib.Path|None,
+                dependencies  : str|None = None) -> tuple[str,list[str]|None]|None:
+        """
+        Restores the generated files from the cache, if the cache contains a valid entry
+
+        :param str key:                         The key of the entry to restore
+        :param str output:                      The file to restore the generated C++ source to
+        :param pathlib.Path|None documentation: Path to documentation output folder, or None for no doc output
+        :param str|None dependencies:           The dependency file to write for the restored
+                                                file, or None to not write a dependency file
+
+        :return: The same as `_export_header`, or None if the cache does not contain a valid entry
+        """
+        entry = self.entry(key)
+        try:
+            with open(str(entry / "entry.json"), encoding='utf-8') as f:
+                data = json.load(f)
+        except (OSError, ValueError):
+            return None
+        for dependency,digest in data["dependencies"].items():
+            if self.hash(dependency) != digest:
+                return None
+        _copy_if_changed(str(entry / "output.gen.cpp"), output)
+        _copy_if_changed(str(entry / "manifest.json"), _manifest_path(output))
+        if data.get("interface"):
+            _copy_if_changed(str(entry / "output.interface"), _interface_path(output))
+        if dependencies:
+            _write_dependency_file(dependencies, output, list(data["dependencies"].keys()))
+        if not documentation:
+            return output,None
+        docs = []
+        for name in data["documentation"]:
+            doc = str(documentation/(name+".xml"))
+            _copy_if_changed(str(entry/(name+".xml")), doc)
+            docs.append(doc)
+        return output,docs
+
+    def store(self, key : str, output : str, docs : list[str]|None, dependencies : str,
+              interface : bool = False):
+        """
+        Stores the generated files in the cache
+
+        :param str key:            The key of the entry to store
+        :param str output:         The generated C++ source file
+        :param list[str]|None docs: The generated XML documentation files; or None if no documentation
+        :param str dependencies:   The dependency file written by the plugin for the header file
+        :param bool interface:     Specifies whether the plugin wrote the interface dump for the
+                                   header file (see `_interface_path`)
+        """
+        entry = self.entry(key)
+        os.makedirs(str(entry), exist_ok=True)
+        # Invalidate any previous entry before overwriting its files
+        pathlib.Path(entry / "entry.json").unlink(missing_ok=True)
+        shutil.copyfile(output, str(entry / "output.gen.cpp"))
+        shutil.copyfile(_manifest_path(output), str(entry / "manifest.json"))
+        if interface:
+            shutil.copyfile(_interface_path(output), str(entry / "output.interface"))
+        names = []
+        for doc in docs or []:
+            name = pathlib.Path(doc).stem
+            shutil.copyfile(doc, str(entry/(name+".xml")))
+            names.append(name)
+        # Hash the files as they are now (not the memoized value), as they were read by clang after
+        # the cache lookup
+        data = {
+            "dependencies": { x: _hash_file(x) for x in _parse_dependency_file(dependencies) },
+            "documentation": names,
+            "interface": interface
+        }
+        with tempfile.NamedTemporaryFile('w', encoding='utf-8', dir=str(entry), delete=False) as f:
+            json.dump(data, f)
+        os.replace(f.name, str(entry / "entry.json"))
+
+_PCH_HEADERS = [
+    "godot_cpp/core/class_db.hpp",
+    "godot_cpp/variant/variant.hpp",
+    "godot_cpp/classes/ref.hpp"
+]
+"""
+The `godot-cpp` headers to include in the precompiled header
+"""
+
+_pch_checked = set()
+"""
+The precompiled headers checked to be up-to-date (or built) by this process, so the headers they
+contain are only hashed once per build, rather than for each header file processed
+"""
+_pch_lock = threading.Lock()
+
+@contextlib.contextmanager
+def _file_lock(path : pathlib.Path):
+    """
+    Gets a context manager object which holds an exclusive lock on a file (created if it does not
+    exist) for the duration of the context, so only one process (or thread) at a time updates the
+    files guarded by the lock
+
+    :param pathlib.Path path: The lock file
+    """
+    with open(str(path), 'a+b') as f:
+        if platform.system() == "Windows":
+            import msvcrt
+            f.seek(0)
+            while True:
+                try:
+                    msvcrt.locking(f.fileno(), msvcrt.LK_LOCK, 1)
+                    break
+                except OSError:
+                    # LK_LOCK only retries for 10 seconds
+                    pass
+            try:
+                yield
+            finally:
+                f.seek(0)
+                msvcrt.locking(f.fileno(), msvcrt.LK_UNLCK, 1)
+        else:
+            import fcntl
+            fcntl.flock(f.fileno(), fcntl.LOCK_EX)
+            try:
+                yield
+            finally:
+                fcntl.flock(f.fileno(), fcntl.LOCK_UN)
+
+def _precompiled_header(pch         : str|None,
+                        clang       : str,
+                        sysincludes : list[str],
+                        includes    : list[str],
+                        args        : list[str],
+                        quiet       : bool = True) -> list[str]:
+    """
+    Gets the arguments to pass to clang to use a precompiled header of the `godot-cpp` headers,
+    building the precompiled header if it does not exist, or if any of the headers it contains has
+    changed since it was built. A precompiled header is built for each combination of the clang
+    version and the arguments passed to clang, as clang can only use a precompiled header built with
+    the same arguments.
+
+    The precompiled header is checked (and built) while holding a lock file in `pch`, so concurrent
+    processes (e.g., parallel SCons jobs) build it once, and never read a partially written file;
+    and only checked once by each process.
+
+    :param str|None pch:          Folder to store the precompiled headers in; `""` (empty string)
+                                  for the default location (`.gdexport_pch` in current working
+                                  directory), or None to not use a precompiled header
+    :param str clang:             Path (relative, absolute, or exe name in PATH) to the clang executable
+    :param list[str] sysincludes: List of paths to treat as system include directories;
+                                  i.e., `-isystem` paths to Clang
+    :param list[str] includes:    List of paths to treat as normal include directories;
+                                  i.e., `-I` paths to Clang
+    :param list[str] args:        List of extra command line arguments to pass to clang
+    :param bool quiet:            Specifies whether to suppress status messages
+
+    :raises subprocess.CalledProcessError: if an error occurs when building the precompiled header
+
+    :return: List of extra command line arguments to pass to clang (i.e., to add to `args`); empty
+             if `pch` is None
+    """
+    if pch is None:
+        return []
+    folder = pathlib.Path(str(pch) if pch else ".gdexport_pch")
+    os.makedirs(str(folder), exist_ok=True)
+
+    arguments = [x for x in _compile_arguments(clang, sysincludes, includes, args) if x != "-fsyntax-only"]
+    umbrella = "".join('#include <{}>\n'.format(x) for x in _PCH_HEADERS)
+    digest = hashlib.sha256(_clang_version_output(str(clang)).stdout.encode('utf-8'))
+    for arg in arguments:
+        digest.update(arg.encode('utf-8') + b'\0')
+    digest.update(umbrella.encode('utf-8'))
+    key = digest.hexdigest()
+    output = folder / (key+".pch")
+
+    with _pch_lock:
+        if str(output) not in _pch_checked:
+            with _file_lock(folder / (key+".lock")):
+                _build_precompiled_header(arguments, umbrella, folder, key, quiet)
+            _pch_checked.add(str(output))
+    return ["-include-pch", str(output)]
+
+def _build_precompiled_header(arguments : list[str],
+                              umbrella  : str,
+                              folder    : pathlib.Path,
+                              key       : str,
+                              quiet     : bool):
+    """
+    Builds the precompiled header (see `_precompiled_header`) if it does not exist, or if any of the
+    headers it contains has changed since it was built. Must be called with the lock held
+
+    :param list[str] arguments: The arguments to pass to clang to build the precompiled header
+    :param str umbrella:        The content of the header to precompile
+    :param pathlib.Path folder: Folder to store the precompiled header in
+    :param str key:             The name of the precompiled header (without extension)
+    :param bool quiet:          Specifies whether to suppress status messages
+
+    :raises subprocess.CalledProcessError: if an error occurs when building the precompiled header
+    """
+    output = folder / (key+".pch")
+    entry = folder / (key+".json")
+    try:
+        with open(str(entry), encoding='utf-8') as f:
+            dependencies = json.load(f)
+        if output.exists() and all(_hash_file(x) == y for x,y in dependencies.items()):
+            return
+    except (OSError, ValueError):
+        pass
+
+    header = folder / (key+".hpp")
+    with open(str(header), 'w', encoding='utf-8') as f:
+        f.write(umbrella)
+    if not quiet:
+        print(" - Building precompiled header {}".format(output))
+    with tempfile.TemporaryDirectory(dir=str(folder)) as tmp:
+        built = pathlib.Path(tmp) / "header.pch"
+        depfile = pathlib.Path(tmp) / "header.d"
+        subprocess.run(arguments + ["-x", "c++-header", str(header), "-o", str(built),
+                                    "-MD", "-MF", str(depfile)], check=True)
+        dependencies = { x: _hash_file(x) for x in _parse_dependency_file(depfile) }
+        with open(str(pathlib.Path(tmp) / "header.json"), 'w', encoding='utf-8') as f:
+            json.dump(dependencies, f)
+        # Replace the precompiled header before the list of its dependencies, so the dependencies
+        # never describe a different precompiled header
+        os.replace(str(built), str(output))
+        os.replace(str(pathlib.Path(tmp) / "header.json"), str(entry))
+
+def _module_map(godot : pathlib.Path) -> str:
+    """
+    Generates the module map of the `godot-cpp` headers: a `godot_cpp` module with a submodule for
+    each header (so only the declarations of the headers included are visible), and a
+    `gdextension` module for the GDExtension C interface
+
+    :param pathlib.Path godot: Absolute path to the root of the checkout of the `godot-cpp` repo
+
+    :return: The content of the module map
+    """
+    def path(x : pathlib.Path) -> str:
+        return json.dumps(x.as_posix())
+    return ("module gdextension [system] {{\n"
+            "    header {}\n"
+            "    export *\n"
+            "}}\n"
+            "\n"
+            "module godot_cpp [system] {{\n"
+            "    module core {{\n"
+            "        umbrella {}\n"
+            "        module * {{ export * }}\n"
+            "    }}\n"
+            "    module gen {{\n"
+            "        umbrella {}\n"
+            "        module * {{ export * }}\n"
+            "    }}\n"
+            "    export *\n"
+            "}}\n").format(path(godot / "gdextension" / "gdextension_interface.h"),
+                           path(godot / "include" / "godot_cpp"),
+                           path(godot / "gen" / "include" / "godot_cpp"))
+
+_modules_checked = set()
+"""
+The module caches (and arguments) updated by this process, so the modules are only checked once per
+build, rather than by a clang process before each header file is processed
+"""
+_modules_lock = threading.Lock()
+
+def _module_cache(modules     : str|None,
+                  clang       : str,
+                  godot       : str|None,
+                  sysincludes : list[str],
+                  includes    : list[str],
+                  args        : list[str],
+                  quiet       : bool = True) -> list[str]:
+    """
+    Gets the arguments to pass to clang to import the `godot-cpp` headers as clang modules, from a
+    module cache shared by all the header files (and by later runs), so each `godot-cpp` header is
+    only parsed once, whichever subset of the headers each header file includes. Unlike a
+    precompiled header, the module map (see `_module_map`) only depends on the `godot-cpp` folder;
+    clang keeps a separate module file in the cache for each set of incompatible arguments, and
+    rebuilds a module file if any of the headers it contains has changed.
+
+    The modules are built (if out of date) before returning, so the clang processes (or threads)
+    processing the header files in parallel load the modules, rather than each waiting for the
+    first to build them (clang builds each module once, with a lock file in the cache). The modules
+    are only checked once by each process for each set of arguments, under a lock file in `modules`
+    (as for `_precompiled_header`)
+
+    :param str|None modules:      Folder to store the module map and module cache in; `""` (empty
+                                  string) for the default location (`.gdexport_modules` in current
+                                  working directory), or None to not use modules
+    :param str clang:             Path (relative, absolute, or exe name in PATH) to the clang executable
+    :param str|None godot:        Path to the root of the checkout of the `godot-cpp` repo
+    :param list[str] sysincludes: List of paths to treat as system include directories;
+                                  i.e., `-isystem` paths to Clang (including the `godot-cpp` paths)
+    :param list[str] includes:    List of paths to treat as normal include directories;
+                                  i.e., `-I` paths to Clang
+    :param list[str] args:        List of extra command line arguments to pass to clang
+    :param bool quiet:            Specifies whether to suppress status messages
+
+    :raises ValueError:                    if `godot` is None
+    :raises subprocess.CalledProcessError: if an error occurs when building the modules
+
+    :return: List of extra command line arguments to pass to clang (i.e., to add to `args`); empty
+             if `modules` is None
+    """
+    if modules is None:
+        return []
+    if not godot:
+        raise ValueError("The path to godot-cpp is required to use modules")
+    folder = pathlib.Path(str(modules) if modules else ".gdexport_modules").resolve()
+    os.makedirs(str(folder), exist_ok=True)
+
+    root = pathlib.Path(str(godot)).resolve()
+    digest = hashlib.sha256(str(root).encode('utf-8')).hexdigest()
+    module_map = folder / "godot_cpp-{}.modulemap".format(digest[:16])
+    arguments = ["-fmodules", "-fmodules-cache-path="+str(folder / "cache"),
+                 "-fmodule-map-file="+str(module_map),
+                 # The godot-cpp headers are system headers, which clang otherwise does not check
+                 "-fmodules-validate-system-headers"]
+
+    command = _compile_arguments(clang, sysincludes, includes, list(args) + arguments) + ["-x", "c++", "-"]
+    key = hashlib.sha256('\0'.join(command).encode('utf-8')).hexdigest()
+
+    with _modules_lock:
+        if key not in _modules_checked:
+            with _file_lock(folder / "godot_cpp-{}.lock".format(digest[:16])):
+                # Only written if changed, as the modules are rebuilt if the module map is modified
+                _write_if_changed(str(module_map), _module_map(root).encode('utf-8'))
+                if not quiet:
+                    print(" - Updating godot-cpp modules in {}".format(folder))
+                umbrella = "".join('#include <{}>\n'.format(x) for x in _PCH_HEADERS)
+                subprocess.run(command, input=umbrella, encoding='utf-8', check=True)
+            _modules_checked.add(key)
+    return arguments
+
+def _load_cache(cache : str|None, plugin : pathlib.Path, clang : str|None = None) -> _HeaderCache|None:
+    """
+    Gets the cache for the generated files, creating the cache folder if necessary
+
+    :param str|None cache:      Path to the cache folder; `""` (empty string) for the default
+                                location (`.gdexport_cache` in current working directory), or
+                                None to not use a cache
+    :param pathlib.Path plugin: Path to the plugin (or batch driver) for gdexport
+    :param str|None clang:      Path to the clang executable loading the plugin, or None for the
+                                batch driver
+
+    :return: The cache, or None if no cache
+    """
+    if cache is None:
+        return None
+    folder = pathlib.Path(str(cache) if cache else ".gdexport_cache")
+    os.makedirs(str(folder), exist_ok=True)
+    return _HeaderCache(folder, plugin, clang)
+
 def generate_all(name           : str,
                  files          : list[str],
                  godot          : str|None  = 'godot-cpp',
@@ -170,7 +1068,22 @@ def generate_all(name           : str,
                  documentation  : str|None  = None,
                  create_folders : bool = True,
                  quiet          : bool = False,
-                 args           : list[str] = []) -> tuple[list[str],list[str]|None,str]:
+                 args           : list[str] = [],
+                 jobs           : int|None  = 1,
+                 cache          : str|None  = None,
+                 batch          : bool      = False,
+                 pch            : str|None  = None,
+                 prescan        : bool      = False,
+                 tables         : bool      = False,
+                 thunks         : bool      = False,
+                 jumbo          : int|None  = None,
+                 doc_jobs       : int       = 0,
+                 stats          : bool      = False,
+                 compile_commands : str|None = None,
+                 modules        : str|None  = None,
+                 doc_budget     : int|None  = None,
+                 interface      : bool      = False,
+                 tool_classes   : str       = "scene") -> tuple[list[str],list[str]|None,str]:
     """
     Generates C++ source files which export the C++ classes, methods, enums,
     signals, etc., marked with `godot::` attributes to be accessible via a
@@ -208,10 +1121,100 @@ def generate_all(name           : str,
                                    (`destination` and `documentation`) if they do not exist
     :param bool quiet:             Specifies whether to suppress status messages
     :param list[str] args:         List of extra command line arguments to pass to clang
+    :param int|None jobs:          Number of clang processes to run in parallel. `None`, or a value
+                                   less than 1, uses the number of CPUs (default = 1)
+    :param str|None cache:         Folder to cache the generated files in, so unchanged headers are
+                                   not processed again. Specify `None` to not use a cache, `""`
+                                   (empty string) to use the default location (`.gdexport_cache`
+                                   in current working directory), or path to directory otherwise
+    :param bool batch:             Specifies whether to process the header files with the batch
+                                   driver, which processes several headers in one process, rather
+                                   than a clang process per header. Each of the `jobs` processes is
+                                   passed an equal share of the headers
+    :param str|None pch:           Folder to store a precompiled header of the `godot-cpp` headers
+                                   in, which is built (once for each clang version and arguments)
+                                   and used when processing the header files. Specify `None` to
+                                   not use a precompiled header, `""` (empty string) to use the
+                                   default location (`.gdexport_pch` in current working directory),
+                                   or path to directory otherwise
+    :param bool prescan:           Specifies whether to check each header file for godot attributes,
+                                   by lexing it, before processing it with clang. For header files
+                                   without any attributes an empty `initialize_<name>()` function is
+                                   generated without running clang
+    :param bool tables:            Specifies whether to register the properties and signals of each
+                                   class from constant tables (with a loop), rather than generating
+                                   a separate call for each property and signal
+    :param bool thunks:            Specifies whether to bind each method with generated (non-template)
+                                   call and ptrcall functions, rather than godot-cpp's `MethodBind`
+                                   templates
+    :param int|None jumbo:         Number of jumbo C++ source files (`<name>.jumbo<N>.cpp`) to
+                                   write, each including a share of the generated `.gen.cpp` files
+                                   (balanced by the number of bindings in each), so the generated
+                                   code is compiled as fewer translation units. The returned list
+                                   contains the jumbo files instead of the `.gen.cpp` files (which
+                                   must not also be compiled). `None` (the default), or a value
+                                   less than 1, to not write jumbo files
+    :param int doc_jobs:           Number of threads to write the XML documentation files for each
+                                   header with, once the header has been parsed, rather than
+                                   writing the file for each class while traversing the header
+                                   (the default, 0)
+    :param bool stats:             Specifies whether the plugin records statistics (the time spent
+                                   processing each header, and the count of, and time spent in,
+                                   each phase: handling attributes, traversing the AST, resolving
+                                   types, writing the generated code, and writing the documentation),
+                                   written alongside each generated file (`<name>.gen.stats.json`),
+                                   and prints a summary table of the statistics, slowest header first
+    :param str|None compile_commands: Compilation database (`compile_commands.json`, or the build
+                                   directory containing it) to read the exact clang command for
+                                   each header from, rather than generating the command from
+                                   `godot`, `sysincludes`, `includes` and `pch`. As headers are not
+                                   listed in the database, the command of the source file most
+                                   likely to include each header is used (e.g., `foo.cpp` for
+                                   `foo.hpp`). The headers are processed by one batch driver process
+                                   with `jobs` threads (`batch` is ignored); with `stats` the
+                                   headers are processed one at a time. `args` are added to each
+                                   command as driver arguments (not wrapped with `-Xclang`). `None` (the default) to not use a compilation database
+    :param str|None modules:       Folder to store a clang module cache of the `godot-cpp` headers
+                                   in (which requires `godot`), imported rather than included by
+                                   each header, so each `godot-cpp` header is parsed once, whichever
+                                   of the `godot-cpp` headers each header includes. The cache is
+                                   shared by all the headers, and by later calls, and is updated
+                                   before the headers are processed. Specify `None` to not use
+                                   modules (the default), `""` (empty string) to use the default
+                                   location (`.gdexport_modules` in current working directory), or
+                                   path to directory otherwise. Cannot be used with `pch`
+    :param int|None doc_budget:    Number of bytes of XML documentation to hold in memory while
+                                   processing each header. The documentation of each method,
+                                   member, signal and constant is written (as XML) as it is parsed,
+                                   and once more than `doc_budget` bytes are held the XML is moved
+                                   to temporary files until the documentation file for the class is
+                                   written; bounding the memory for headers with very large
+                                   documentation. The documentation files are the same, except the
+                                   entries of each section are in declaration order. `None` (the
+                                   default) to keep the parsed documentation of each class in memory
+    :param bool interface:         Specifies whether to write a dump of the exported interface
+                                   (classes, methods and their arguments, properties, groups,
+                                   signals and constants, with the resolved godot types) of each
+                                   header alongside the generated file (`<name>.gen.interface`),
+                                   and an index of the dumps (`<name>.interface.json`, in
+                                   `destination`), so other tools can load the interface without
+                                   running clang (see `read_interface`). The dumps are restored
+                                   from the cache with the generated files
+    :param str tool_classes:       How to register the classes marked with `[[godot::tool]]`, and
+                                   the classes inheriting from them: `"scene"` (the default) with
+                                   the other classes, `"editor"` at the editor initialization level,
+                                   or `"tools_enabled"` only in builds with `TOOLS_ENABLED` defined.
+                                   Whichever is specified, the entry point registers each class
+                                   after the class it inherits from, from the plan read from the
+                                   manifest of each generated file (see `entry_point`)
 
     :raises ValueError:         If name is not a valid C++ identifier (valid identifier
                                 contains only [a-zA-Z0-9_] and cannot start with a number)
     :raises ValueError:         If no files are specified, or a specified file does not exist
+    :raises ValueError:         If `tool_classes` is not one of `"scene"`, `"editor"` or
+                                `"tools_enabled"`
+    :raises ValueError:         If both `pch` and `modules` are specified, or `modules` is
+                                specified without `godot`
     :raises FileExistsError:    If `destination` or `documentation` folder does not exist,
                                 and `create_folders` is `False`
     :raises NotADirectoryError: If `destination` or `documentation` folder is a file
@@ -238,6 +1241,8 @@ def generate_all(name           : str,
         filepath = pathlib.Path(str(file))
         if not filepath.exists():
             raise ValueError("Specified file does not exist: "+str(file))
+    if tool_classes not in _TOOL_CLASSES:
+        raise ValueError("Unknown registration of tool classes: "+str(tool_classes))
 
     version = _check_clang_version(clang)
     if not quiet:
@@ -250,49 +1255,163 @@ def generate_all(name           : str,
         documentation = "doc_classes"
     docdest = _dest_folder(documentation, create_folders, 'documentation')
 
-    sysincludes = _load_godot_paths(godot, sysincludes)
+    if compile_commands:
+        database = pathlib.Path(str(compile_commands))
+        if database.is_dir():
+            database = database / "compile_commands.json"
+        if not database.is_file():
+            raise ValueError("Specified compilation database does not exist: "+str(compile_commands))
+        compile_commands = str(database)
+    else:
+        if pch is not None and modules is not None:
+            raise ValueError("A precompiled header and modules cannot both be used")
+        sysincludes = _load_godot_paths(godot, sysincludes)
+        args = (list(args) + _precompiled_header(pch, clang, sysincludes, includes, args, quiet)
+                + _module_cache(modules, clang, godot, sysincludes, includes, args, quiet))
 
     result = []
     docs = []
-    with _get_plugin_path() as library:
-        arguments = _load_arguments(clang, library, sysincludes, includes, documentation, args)
-
-        for file in files:
-            filepath = pathlib.Path(str(file))
-            destfile = filepath.with_suffix(".gen.cpp").name
-            if dest:
-                destfile = str(dest / destfile)
-            arguments[-2] = destfile
-            result.append(destfile)
-
-            if not quiet:
-                print(" - Processing {} > {}".format(str(file), destfile))
-            arguments[-1] = str(file)
-            generated,generated_docs = _export_header(arguments, docdest)
-            result.append(generated)
-            if generated_docs:
-                docs += generated_docs
+    headers = []
+    for file in files:
+        filepath = pathlib.Path(str(file))
+        destfile = filepath.with_suffix(".gen.cpp").name
+        if dest:
+            destfile = str(dest / destfile)
+        headers.append((str(file), destfile))
+    # Every generated file (including stubs), to read the registration plan from
+    generated_outputs = [x[1] for x in headers]
+
+    if stats:
+        # Statistics are only written for the headers processed (not restored from the cache)
+        for file,destfile in headers:
+            pathlib.Path(_stats_path(destfile)).unlink(missing_ok=True)
+
+    stubs = {}
+    if prescan:
+        for file,destfile in headers:
+            if not _has_godot_attributes(file):
+                if not quiet:
+                    print(" - Skipping {} (no godot attributes) > {}".format(file, destfile))
+                stubs[file] = _write_stub(file, destfile, docdest)
+        headers = [x for x in headers if x[0] not in stubs]
+
+    if not headers:
+        generated_files = []
+    elif compile_commands:
+        # Only the extra arguments; the command for each header is read from the database. Passed
+        # to the driver (as in the database commands), not wrapped with -Xclang, so driver options
+        # (e.g., -I, -D, -std=) are handled as for the rest of the command
+        extra = ["-DGDEXPORT_GENERATING"] + [str(x) for x in args]
+        extra += ["-resource-dir", _resource_dir(str(clang))]
+        with _get_batch_path() as driver:
+            generated_files = _export_headers_batch(driver, extra, headers, docdest,
+                                                    _load_cache(cache, driver),
+                                                    1 if stats else _job_count(jobs), quiet, tables,
+                                                    thunks, doc_jobs, stats, compile_commands,
+                                                    doc_budget=doc_budget, interface=interface)
+    elif batch:
+        with _get_batch_path() as driver:
+            generated_files = _export_headers_batch(driver,
+                                                    _batch_arguments(clang, sysincludes, includes, args),
+                                                    headers, docdest, _load_cache(cache, driver),
+                                                    _job_count(jobs), quiet, tables, thunks, doc_jobs,
+                                                    stats, doc_budget=doc_budget, interface=interface)
+    else:
+        with _get_plugin_path() as library:
+            arguments = _load_arguments(clang, library, sysincludes, includes, documentation, args,
+                                        tables, thunks, doc_jobs, doc_budget)
+            header_cache = _load_cache(cache, library, clang)
+
+            def process(header : tuple[str,str]) -> tuple[str,list[str]|None]:
+                if not quiet:
+                    print(" - Processing {} > {}".format(header[0], header[1]))
+                return _export_header(arguments[:-2] + [header[1], header[0]], docdest, header_cache,
+                                      stats=stats, interface=interface)
+
+            # Executor.map returns the results in the order of the input files, regardless of the
+            # order in which the clang processes finish
+            with ThreadPoolExecutor(max_workers=_job_count(jobs)) as pool:
+                generated_files = list(pool.map(process, headers))
+
+    if stats:
+        _print_stats(headers)
+
+    if stubs:
+        # Restore the order of the input files
+        generated = iter(generated_files)
+        generated_files = [stubs[str(x)] if str(x) in stubs else next(generated) for x in files]
+
+    for generated,generated_docs in generated_files:
+        result.append(generated)
+        if generated_docs:
+            docs += generated_docs
+
+    if jumbo and jumbo > 0:
+        outputs = jumbo_outputs(name, result, jumbo, destination=str(dest) if dest else None)
+        if not quiet:
+            print(" - Generating {}".format(", ".join(outputs)))
+        result = write_jumbo(result, outputs)
 
     library_cpp = name+".lib.cpp"
     if dest:
         library_cpp = str(dest / library_cpp)
     result.append(library_cpp)
+    if interface:
+        index = name+".interface.json"
+        if dest:
+            index = str(dest / index)
+        if not quiet:
+            print(" - Generating {}".format(index))
+        _write_interface_index(index, headers)
     if not quiet:
         print(" - Generating {}".format(library_cpp))
-    entry = _entry_point(name, files, library_cpp)
+    entry = _entry_point(name, files, library_cpp, generated_outputs, tool_classes)
     if documentation:
         return result,docs,entry
     else:
         return result,None,entry
 
-def _export_header(arguments : list[str], documentation : pathlib.Path|None) -> tuple[str,list[str]|None]:
+def _export_header(arguments     : list[str],
+                   documentation : pathlib.Path|None,
+                   cache         : _HeaderCache|None = None,
+                   server        : pathlib.Path|None = None,
+                   tables        : bool = False,
+                   thunks        : bool = False,
+                   doc_jobs      : int  = 0,
+                   stats         : bool = False,
+                   dependencies  : str|None = None,
+                   doc_budget    : int|None = None,
+                   interface     : bool = False) -> tuple[str,list[str]|None]:
     """
-    Call clang with the plugin to process a header file
+    Call clang with the plugin to process a header file, or restore the generated files from the
+    cache if the header (and the files it includes) are unchanged
 
     :param list[str] arguments: The arguments to pass to `subprocess` to run clang; i.e., the
                                 arguments returned by `_load_arguments` with the last two arguments
-                                replaced with output and input file for the header file to process
+                                replaced with output and input file for the header file to process.
+                                If `server` is specified, the arguments returned by `_batch_arguments`
+                                followed by the output and input file instead
     :param pathlib.Path|None documentation: Path to documentation output folder, or None for no doc output
+    :param _HeaderCache|None cache: The cache for the generated files, or None for no cache
+    :param pathlib.Path|None server: Path to the batch driver to send the request to process
+                                     the header file to a server (see `_Server`), or None to run clang
+    :param bool tables: Specifies whether the server registers properties and signals from constant
+                        tables (when running clang, `arguments` already contains the plugin argument)
+    :param bool thunks: Specifies whether the server binds methods with generated call and ptrcall
+                        functions (when running clang, `arguments` already contains the plugin argument)
+    :param int doc_jobs: Number of threads the server writes the XML documentation files with (when
+                         running clang, `arguments` already contains the plugin argument)
+    :param bool stats: Specifies whether the plugin writes the statistics for the header
+                       (see `_stats_path`)
+    :param str|None dependencies: The dependency file to write (also written when the generated
+                                  files are restored from the cache), or None
+    :param int|None doc_budget: Number of bytes of XML documentation the server holds in memory, or
+                                None (when running clang, `arguments` already contains the plugin
+                                argument)
+    :param bool interface: Specifies whether the plugin writes the interface dump for the header
+                           (see `_interface_path`; also restored from the cache)
+
+    The plugin also writes the manifest for the generated file (see `_manifest_path`).
 
     :raises subprocess.CalledProcessError: if an error occurs when calling `clang`
 
@@ -301,12 +1420,369 @@ def _export_header(arguments : list[str], documentation : pathlib.Path|None) ->
                - If `documentation` is not `None` then a list of strings containing the file
                  paths/names of the generated XML documentation files; otherwise None
     """
+    output = arguments[-2]
+    manifest = _manifest_path(output)
+    statistics = _stats_path(output) if stats else None
+    dump = _interface_path(output) if interface else None
+
+    def run(dependencies : str|None) -> tuple[str,list[str]|None]:
+        if server:
+            with _connect_server(server) as connection:
+                return connection.export(arguments[:-2], arguments[-1], output, documentation,
+                                         dependencies, manifest, tables, thunks, doc_jobs, statistics,
+                                         doc_budget, dump)
+        extra = _plugin_arguments("-manifest", manifest)
+        if dump:
+            extra += _plugin_arguments("-interface", dump)
+        if statistics:
+            extra += _plugin_arguments("-stats", statistics)
+        if dependencies:
+            extra += _plugin_arguments("-deps", dependencies)
+        return _run_plugin(arguments + extra, output, documentation)
+
+    if not cache:
+        return run(dependencies)
+
+    # The options only passed to the plugin by the server request (as for the batch driver), and
+    # so not in the arguments, are added to the key; before the arguments, as the key includes the
+    # hash of the last argument (the header file)
+    options = ["-interface"] if interface else []
+    if server:
+        if documentation:
+            options += ["-doc", str(documentation)]
+            if doc_jobs > 0:
+                options += ["-doc-jobs", str(doc_jobs)]
+            if doc_budget is not None:
+                options += ["-doc-budget", str(doc_budget)]
+        if tables:
+            options += ["-tables"]
+        if thunks:
+            options += ["-thunks"]
+    key = cache.key(options + arguments)
+    restored = cache.restore(key, output, documentation, dependencies)
+    if restored:
+        return restored
+    if dependencies:
+        result = run(dependencies)
+        cache.store(key, result[0], result[1], dependencies, interface)
+        return result
+    with tempfile.TemporaryDirectory(dir=str(cache.folder)) as tmp:
+        dependencies = str(pathlib.Path(tmp) / "header.d")
+        result = run(dependencies)
+        cache.store(key, result[0], result[1], dependencies, interface)
+    return result
+
+class _Server:
+    """
+    A long-lived batch driver process (`gdexport-batch -server`), which processes header files
+    on request without starting a new process (and loading clang) for each header file.
+
+    Requests are written to the process' stdin as a JSON object per line. For each request the
+    server prints the names of the classes for which documentation is generated, followed by
+    `:done <status>`.
+    """
+
+    def __init__(self, driver : pathlib.Path):
+        """
+        Starts the server
+
+        :param pathlib.Path driver: Path to the batch driver
+        """
+        self.process = subprocess.Popen([str(driver), "-server"], stdin=subprocess.PIPE,
+                                        stdout=subprocess.PIPE, encoding='utf-8')
+        # Whether the response to every request has been read, so the server can be reused
+        self.synced = True
+
+    def alive(self) -> bool:
+        """
+        Gets whether the server process is still running
+        """
+        return self.process.poll() is None
+
+    def export(self,
+               command       : list[str],
+               file          : str,
+               output        : str,
+               documentation : pathlib.Path|None,
+               dependencies  : str|None,
+               manifest      : str|None,
+               tables        : bool = False,
+               thunks        : bool = False,
+               doc_jobs      : int  = 0,
+               stats         : str|None = None,
+               doc_budget    : int|None = None,
+               interface     : str|None = None) -> tuple[str,list[str]|None]:
+        """
+        Process a header file with the server
+
+        :param list[str] command:               The clang arguments; i.e., the arguments returned by
+                                                `_batch_arguments`
+        :param str file:                        The header file to process
+        :param str output:                      The C++ source file to generate
+        :param pathlib.Path|None documentation: Path to documentation output folder, or None for no doc output
+        :param str|None dependencies:           The dependency file to write, or None
+        :param str|None manifest:               The manifest file to write, or None
+        :param bool tables:                     Specifies whether to register properties and signals
+                                                from constant tables
+        :param bool thunks:                     Specifies whether to bind methods with generated
+                                                call and ptrcall functions
+        :param int doc_jobs:                    Number of threads to write the XML documentation
+                                                files with
+        :param str|None stats:                  The statistics file to write, or None
+        :param int|None doc_budget:             Number of bytes of XML documentation to hold in
+                                                memory, or None
+        :param str|None interface:              The interface dump to write, or None
+
+        :raises subprocess.CalledProcessError: if an error occurs when processing the header file
+        :raises OSError:                       if the server exits unexpectedly
+
+        :return: The same as `_export_header`
+        """
+        request = { "command": [str(x) for x in command], "header": str(file), "output": str(output) }
+        if documentation:
+            request["documentation"] = str(documentation)
+        if dependencies:
+            request["dependencies"] = str(dependencies)
+        if manifest:
+            request["manifest"] = str(manifest)
+        if stats:
+            request["stats"] = str(stats)
+        if interface:
+            request["interface"] = str(interface)
+        if tables:
+            request["tables"] = True
+        if thunks:
+            request["thunks"] = True
+        if documentation and doc_jobs > 0:
+            request["doc_jobs"] = doc_jobs
+        if documentation and doc_budget is not None:
+            request["doc_budget"] = doc_budget
+        self.synced = False
+        self.process.stdin.write(json.dumps(request)+'\n')
+        self.process.stdin.flush()
+        names = []
+        for line in self.process.stdout:
+            line = line.strip()
+            if line.startswith(":done "):
+                self.synced = True
+                if line != ":done 0":
+                    raise subprocess.CalledProcessError(1, command + [str(file)])
+                if documentation:
+                    return output,[str(documentation/(x+".xml")) for x in names]
+                return output,None
+            elif line != '' and not line.startswith(":file "):
+                names.append(line)
+        raise OSError("The gdexport server exited unexpectedly")
+
+    def stop(self):
+        """
+        Stops the server (closing stdin ends the server once the current request is complete)
+        """
+        self.process.stdin.close()
+        self.process.wait()
+
+    def kill(self):
+        """
+        Kills the server (e.g., if the response to a request could not be read)
+        """
+        self.process.kill()
+        self.process.wait()
+
+_servers = {}
+"""
+The idle servers for each batch driver path
+"""
+_servers_lock = threading.Lock()
+
+@contextlib.contextmanager
+def _connect_server(driver : pathlib.Path):
+    """
+    Gets a context manager object for an idle server for the batch driver, starting a new server if
+    there is no idle server (e.g., when called from several threads). The server is returned to the
+    idle servers at the end of the context, so it is reused for later requests, unless the response
+    to its request was not read (in which case it is killed, as the rest of the response would be
+    read as the response to the next request)
+
+    ```
+    with _connect_server(driver) as server:
+        server.export(...)
+    ```
+
+    :param pathlib.Path driver: Path to the batch driver
+    """
+    server = None
+    with _servers_lock:
+        idle = _servers.setdefault(str(driver), [])
+        while idle and server is None:
+            server = idle.pop()
+            if not server.alive():
+                server = None
+    if server is None:
+        server = _Server(driver)
+    try:
+        yield server
+    finally:
+        if server.alive() and server.synced:
+            with _servers_lock:
+                _servers[str(driver)].append(server)
+        elif server.alive():
+            server.kill()
+
+@atexit.register
+def _stop_servers():
+    """
+    Stops all the idle servers
+    """
+    with _servers_lock:
+        for idle in _servers.values():
+            for server in idle:
+                server.stop()
+        _servers.clear()
+
+def _export_headers_batch(driver        : pathlib.Path,
+                          arguments     : list[str],
+                          headers       : list[tuple[str,str]],
+                          documentation : pathlib.Path|None,
+                          cache         : _HeaderCache|None,
+                          jobs          : int,
+                          quiet         : bool,
+                          tables        : bool = False,
+                          thunks        : bool = False,
+                          doc_jobs      : int  = 0,
+                          stats         : bool = False,
+                          compile_commands : str|None = None,
+                          doc_budget    : int|None = None,
+                          interface     : bool = False) -> list[tuple[str,list[str]|None]]:
+    """
+    Process several header files with the batch driver (`gdexport-batch`), restoring the generated
+    files from the cache for unchanged headers
+
+    :param pathlib.Path driver:             Path to the batch driver
+    :param list[str] arguments:             The clang arguments to pass to the batch driver; i.e.,
+                                            the arguments returned by `_batch_arguments`
+    :param list[tuple[str,str]] headers:    The header files to process, and the generated C++
+                                            source file for each
+    :param pathlib.Path|None documentation: Path to documentation output folder, or None for no doc output
+    :param _HeaderCache|None cache:         The cache for the generated files, or None for no cache
+    :param int jobs:                        The number of batch driver processes to run in parallel
+    :param bool quiet:                      Specifies whether to suppress status messages
+    :param bool tables:                     Specifies whether to register properties and signals
+                                            from constant tables
+    :param bool thunks:                     Specifies whether to bind methods with generated call
+                                            and ptrcall functions
+    :param int doc_jobs:                    Number of threads to write the XML documentation files
+                                            for each header with
+    :param bool stats:                      Specifies whether to write the statistics for each
+                                            header (see `_stats_path`)
+    :param str|None compile_commands:       The compilation database to read the clang command for
+                                            each header from, in which case `arguments` are the
+                                            extra arguments added to each command, and the
+                                            headers are processed by one driver process with
+                                            `jobs` threads; or None to use `arguments` as the
+                                            clang command
+    :param int|None doc_budget:             Number of bytes of XML documentation to hold in memory
+                                            for each header, or None
+    :param bool interface:                  Specifies whether to write the interface dump for each
+                                            header (see `_interface_path`)
+
+    :raises subprocess.CalledProcessError: if an error occurs when processing any header file
+
+    :return: List containing the same as `_export_header` for each header file, in the order of `headers`
+    """
+    command = [str(driver)]
+    database = []
+    if compile_commands:
+        command += ["-compile-commands", str(compile_commands), "-jobs", str(jobs)]
+        # The commands (and so the generated files) change when the compilation database changes
+        database = [_hash_file(str(compile_commands)) or ""]
+    if documentation:
+        command += ["-doc", str(documentation)]
+        if doc_jobs > 0:
+            command += ["-doc-jobs", str(doc_jobs)]
+        if doc_budget is not None:
+            command += ["-doc-budget", str(doc_budget)]
+    if tables:
+        command.append("-tables")
+    if thunks:
+        command.append("-thunks")
+    results = [None] * len(headers)
+    keys = {}
+    pending = []
+    for index,(file,output) in enumerate(headers):
+        if cache:
+            keys[index] = cache.key(command + database + (["-interface"] if interface else []) + arguments
+                                    + [output, file])
+            restored = cache.restore(keys[index], output, documentation)
+            if restored:
+                results[index] = restored
+                continue
+        if not quiet:
+            print(" - Processing {} > {}".format(file, output))
+        pending.append(index)
+    if not pending:
+        return results
+
+    with tempfile.TemporaryDirectory() as tmp:
+        def run(chunk : list[int]):
+            header_list = pathlib.Path(tmp) / "headers{}.txt".format(chunk[0])
+            with open(str(header_list), 'w', encoding='utf-8') as f:
+                for index in chunk:
+                    fields = list(headers[index])
+                    fields.append(str(pathlib.Path(tmp) / "{}.d".format(index)) if cache else "")
+                    fields.append(_manifest_path(headers[index][1]))
+                    if stats or interface:
+                        fields.append(_stats_path(headers[index][1]) if stats else "")
+                    if interface:
+                        fields.append(_interface_path(headers[index][1]))
+                    f.write('\t'.join(fields)+'\n')
+            stdout = subprocess.check_output(command + [str(header_list), "--"] + arguments, encoding='utf-8')
+            # The driver prints ":file <header>" before the class names for each header (in the
+            # order the headers finish, with -compile-commands)
+            names = {}
+            classes = None
+            for line in stdout.splitlines():
+                if line.startswith(":file "):
+                    classes = names.setdefault(line[6:], [])
+                elif classes is not None and line.strip() != '':
+                    classes.append(line.strip())
+            for index in chunk:
+                output = headers[index][1]
+                classes = names.get(headers[index][0], [])
+                docs = [str(documentation/(x+".xml")) for x in classes] if documentation else None
+                results[index] = (output, docs)
+                if cache:
+                    cache.store(keys[index], output, docs, str(pathlib.Path(tmp) / "{}.d".format(index)),
+                                interface)
+
+        if compile_commands:
+            chunks = [pending]
+        else:
+            chunks = [pending[i::jobs] for i in range(min(jobs, len(pending)))]
+        with ThreadPoolExecutor(max_workers=len(chunks)) as pool:
+            # Consume the results so any exception is raised
+            list(pool.map(run, chunks))
+    return results
+
+def _run_plugin(arguments     : list[str],
+                output        : str,
+                documentation : pathlib.Path|None) -> tuple[str,list[str]|None]:
+    """
+    Call clang with the plugin to process a header file
+
+    :param list[str] arguments: The arguments to pass to `subprocess` to run clang
+    :param str output:          The C++ source file the plugin generates
+    :param pathlib.Path|None documentation: Path to documentation output folder, or None for no doc output
+
+    :raises subprocess.CalledProcessError: if an error occurs when calling `clang`
+
+    :return: The same as `_export_header`
+    """
     if documentation:
         result = subprocess.check_output(arguments, encoding='utf-8')
-        return arguments[-2],[str(documentation/(x.strip()+".xml")) for x in result.splitlines() if x.strip() != '']
+        return output,[str(documentation/(x.strip()+".xml")) for x in result.splitlines() if x.strip() != '']
     else:
         subprocess.run(arguments, check=True)
-        return arguments[-2],None
+        return output,None
 
 def export_header(file           : str,
                   output         : str|None  = None,
@@ -317,7 +1793,18 @@ def export_header(file           : str,
                   destination    : str|None  = None,
                   documentation  : str|None  = None,
                   create_folders : bool      = True,
-                  args           : list[str] = []) -> tuple[str,list[str]|None]:
+                  args           : list[str] = [],
+                  cache          : str|None  = None,
+                  pch            : str|None  = None,
+                  server         : bool      = False,
+                  prescan        : bool      = False,
+                  tables         : bool      = False,
+                  thunks         : bool      = False,
+                  doc_jobs       : int       = 0,
+                  dependencies   : bool      = False,
+                  modules        : str|None  = None,
+                  doc_budget     : int|None  = None,
+                  interface      : bool      = False) -> tuple[str,list[str]|None]:
     """
     Generates a C++ source file, and optionally XML documentation, which export the C++ classes,
     methods, enums, signals, etc., marked with `godot::` attributes from the specified C++ header file.
@@ -349,8 +1836,43 @@ def export_header(file           : str,
                                    (`destination` and `documentation) if they do not exist
     :param bool quiet:             Specifies whether to suppress status messages
     :param list[str] args:         List of extra command line arguments to pass to clang
+    :param str|None cache:         Folder to cache the generated files in, so an unchanged header is
+                                   not processed again. Specify `None` to not use a cache, `""`
+                                   (empty string) to use the default location (`.gdexport_cache`
+                                   in current working directory), or path to directory otherwise
+    :param str|None pch:           Folder to store a precompiled header of the `godot-cpp` headers
+                                   in. Specify `None` to not use a precompiled header, `""` (empty
+                                   string) to use the default location (`.gdexport_pch` in current
+                                   working directory), or path to directory otherwise
+    :param bool server:            Specifies whether to process the header file with a long-lived
+                                   server process (the batch driver `gdexport-batch`), started on
+                                   the first call and reused by later calls, rather than starting
+                                   clang for each header file
+    :param bool prescan:           Specifies whether to check the header file for godot attributes, by
+                                   lexing it, before processing it with clang (see `generate_all`)
+    :param bool tables:            Specifies whether to register the properties and signals from
+                                   constant tables (see `generate_all`)
+    :param bool thunks:            Specifies whether to bind the methods with generated call and
+                                   ptrcall functions (see `generate_all`)
+    :param int doc_jobs:           Number of threads to write the XML documentation files with
+                                   (see `generate_all`)
+    :param bool dependencies:      Specifies whether to write a Makefile-style dependency file
+                                   alongside the generated file (`<name>.gen.d`), listing the header
+                                   file and every file included when processing it, so a build system
+                                   can regenerate the file when any of them change (see
+                                   `header_dependencies`)
+    :param str|None modules:       Folder to store a clang module cache of the `godot-cpp` headers
+                                   in (see `generate_all`). Cannot be used with `pch`
+    :param int|None doc_budget:    Number of bytes of XML documentation to hold in memory
+                                   (see `generate_all`)
+    :param bool interface:         Specifies whether to write a dump of the exported interface
+                                   alongside the generated file (`<name>.gen.interface`; see
+                                   `read_interface`). The index of the dumps is only written by
+                                   `generate_all`
 
     :raises ValueError:         If the specified input file does not exist
+    :raises ValueError:         If both `pch` and `modules` are specified, or `modules` is
+                                specified without `godot`
     :raises FileExistsError:    If `destination` (and `output` not specified) or `documentation`
                                 folder does not exist, and `create_folders` is `False`
     :raises NotADirectoryError: If `destination` (and `output` not specified) or `documentation` folder is a file
@@ -380,48 +1902,150 @@ def export_header(file           : str,
         documentation = "doc_classes"
     docdest = _dest_folder(documentation, create_folders, 'documentation')
 
+    depsfile = _dependency_path(str(output)) if dependencies else None
+    if prescan and not _has_godot_attributes(str(file)):
+        if depsfile:
+            # The stub only depends on the header file
+            _write_dependency_file(depsfile, str(output), [str(file)])
+        return _write_stub(str(file), str(output), docdest)
+
+    if pch is not None and modules is not None:
+        raise ValueError("A precompiled header and modules cannot both be used")
     sysincludes = _load_godot_paths(godot, sysincludes)
+    args = (list(args) + _precompiled_header(pch, clang, sysincludes, includes, args)
+            + _module_cache(modules, clang, godot, sysincludes, includes, args))
+
+    if server:
+        with _get_batch_path() as driver:
+            arguments = _batch_arguments(clang, sysincludes, includes, args) + [str(output), str(file)]
+            return _export_header(arguments, docdest, _load_cache(cache, driver), driver, tables, thunks,
+                                  doc_jobs, dependencies=depsfile, doc_budget=doc_budget,
+                                  interface=interface)
 
     with _get_plugin_path() as library:
-        arguments = _load_arguments(clang, library, sysincludes, includes, documentation, args)
+        arguments = _load_arguments(clang, library, sysincludes, includes, documentation, args,
+                                    tables, thunks, doc_jobs, doc_budget)
         arguments[-2] = str(output)
         arguments[-1] = str(file)
-        return _export_header(arguments, docdest)
+        return _export_header(arguments, docdest, _load_cache(cache, library, clang), dependencies=depsfile,
+                              interface=interface)
+
+_TOOL_CLASSES = ["scene", "editor", "tools_enabled"]
 
-def _entry_point(name : str, files : list[str], output : str) -> str:
+def _registration_plan(headers : list[tuple[str,str]], tool_classes : str) -> tuple[list[str],list[str]]|None:
+    """
+    Builds the plan for registering the exported classes from the manifest written for each
+    generated file; i.e., the function (generated for each class) which registers each class, in an
+    order in which each class is registered after the class it inherits from (if also exported by
+    the extension), split into the classes registered at the scene level, and the tool classes
+    registered later (see `tool_classes`)
+
+    :param list[tuple[str,str]] headers: The header files, and the generated C++ source file for each
+    :param str tool_classes: How to register the tool classes, and the classes inheriting from
+                             them: `"scene"` to register them with the other classes (so there are
+                             no deferred classes), `"editor"` to register them at the editor
+                             initialization level, or `"tools_enabled"` to only register them (at
+                             the scene level) in builds with `TOOLS_ENABLED` defined
+
+    :return: Two-tuple containing the registration functions of the classes registered at the
+             scene level, and of the deferred classes; or None if the manifest of any header is
+             missing, or out-of-date
+    """
+    classes = {}
+    for file,output in headers:
+        manifest = _read_manifest(str(output), str(file))
+        if manifest is None:
+            return None
+        for cls in manifest["classes"]:
+            if "register" not in cls:
+                # Written by an earlier version of the plugin
+                return None
+            # Without the leading `::` (only written for classes declared in a namespace), so the
+            # base of every class is matched, however it was qualified
+            classes[cls["qualified_name"].removeprefix("::")] = cls
+
+    order = []
+    deferred = {}
+    def visit(cls : dict):
+        if cls["qualified_name"] in deferred:
+            return
+        # Marked before visiting the base class, so is never visited twice
+        deferred[cls["qualified_name"]] = False
+        base = classes.get(cls.get("base", "").removeprefix("::"))
+        if base is not None:
+            visit(base)
+        deferred[cls["qualified_name"]] = ((tool_classes != "scene")
+                                           and (cls["tool"] or (base is not None and deferred[base["qualified_name"]])))
+        order.append(cls)
+
+    for cls in classes.values():
+        visit(cls)
+    # The base of a class registered at the scene level is never deferred, so the order is kept
+    return ([x["register"] for x in order if not deferred[x["qualified_name"]]],
+            [x["register"] for x in order if deferred[x["qualified_name"]]])
+
+def _entry_point(name         : str,
+                 files        : list[str],
+                 output       : str,
+                 outputs      : list[str]|None = None,
+                 tool_classes : str = "scene") -> str:
     """
     Generates a C++ source file containing the entry point of the GDExtension for registering all
     the exported classes etc. which will be exported from the specified C++ header files.
 
     See README.md for details on the attributes necessary for the export.
 
-    :param str name:         Name of the GDExtension.
-    :param list[str] files:  List of C++ header files for which files have been (or will be)
-                             generated
-    :param stroutput:        Specifies the file to output the generated code to.
+    :param str name:                  Name of the GDExtension.
+    :param list[str] files:           List of C++ header files for which files have been (or will be)
+                                      generated
+    :param str output:                Specifies the file to output the generated code to.
+    :param list[str]|None outputs:    The C++ source file generated for each of the `files`, to read
+                                      the registration plan from (see `_registration_plan`); or None
+                                      to register the classes of each header in the order of `files`
+    :param str tool_classes:          How to register the tool classes (see `_registration_plan`)
 
     :return: The name of the C++ function generated as the extension's entry point;
              i.e., the value returned by `entry_point_name`
     """
-    ids = [re.sub("[^a-zA-Z0-9_]", '_', pathlib.Path(str(x)).stem) for x in files]
-    with open(str(output), 'w', encoding='utf-8') as f:
+    plan = None
+    if outputs is not None:
+        plan = _registration_plan(list(zip(files, outputs)), tool_classes)
+    if plan is None:
+        # Without the manifests the classes are registered header by header, with the tool classes
+        scene = ['initialize_' + re.sub("[^a-zA-Z0-9_]", '_', pathlib.Path(str(x)).stem) for x in files]
+        deferred = []
+    else:
+        scene,deferred = plan
+    with _open_if_changed(str(output)) as f:
         f.write('#include <gdextension_interface.h>\n'
                 '#include <godot_cpp/core/defs.hpp>\n'
                 '#include <godot_cpp/godot.hpp>\n'
                 '\n'
                 'using namespace godot;\n'
                 '\n')
-        for identifier in ids:
-            f.write('void initialize_{0}();\n'.format(identifier))
+        for function in scene + deferred:
+            f.write('void {0}();\n'.format(function))
         f.write(('\n'
                  'void initialize_{0}_module(ModuleInitializationLevel p_level)\n'
-                 '{{\n'
-                 '    if(p_level != MODULE_INITIALIZATION_LEVEL_SCENE)\n'
-                 '    {{\n'
-                 '        return;\n'
-                 '    }}\n').format(name))
-        for identifier in ids:
-            f.write('    initialize_{0}();\n'.format(identifier))
+                 '{{\n').format(name))
+        if deferred and tool_classes == "editor":
+            f.write('    if(p_level == MODULE_INITIALIZATION_LEVEL_EDITOR)\n'
+                    '    {\n')
+            for function in deferred:
+                f.write('        {0}();\n'.format(function))
+            f.write('        return;\n'
+                    '    }\n')
+        f.write('    if(p_level != MODULE_INITIALIZATION_LEVEL_SCENE)\n'
+                '    {\n'
+                '        return;\n'
+                '    }\n')
+        for function in scene:
+            f.write('    {0}();\n'.format(function))
+        if deferred and tool_classes == "tools_enabled":
+            f.write('#ifdef TOOLS_ENABLED\n')
+            for function in deferred:
+                f.write('    {0}();\n'.format(function))
+            f.write('#endif\n')
         f.write(('}}\n'
                  '\n'
                  'void uninitialize_{0}_module(ModuleInitializationLevel p_level)\n'
@@ -452,7 +2076,9 @@ def entry_point(name           : str,
                 files          : list[str],
                 output         : str|None = None,
                 destination    : str|None = None,
-                create_folders : bool = True) -> str:
+                create_folders : bool = True,
+                outputs        : list[str]|None = None,
+                tool_classes   : str = "scene") -> str:
     """
     Generates a C++ source file containing the entry point of the GDExtension for registering all
     the exported classes etc. which will be exported from the specified C++ header files.
@@ -473,10 +2099,26 @@ def entry_point(name           : str,
                                    (default = current working directory)
     :param bool create_folders:    Specify whether to create the output folder
                                    (`destination`) if it does not exist (and `output` is not set)
+    :param list[str]|None outputs: The C++ source file generated for each of the `files`. If
+                                   specified, and the manifest of every generated file is
+                                   up-to-date, the classes are registered from the plan read from
+                                   the manifests: each class after the class it inherits from
+                                   (whichever header exports it), and the tool classes as
+                                   specified by `tool_classes`. Otherwise (the default) the classes
+                                   of each header are registered in the order of the `files`
+    :param str tool_classes:       How to register the classes marked with `[[godot::tool]]`, and
+                                   the classes inheriting from them, when registering from the plan:
+                                   `"scene"` (the default) with the other classes,
+                                   `"editor"` at the editor initialization level (so they are only
+                                   registered when the extension is loaded by the editor), or
+                                   `"tools_enabled"` only in builds with `TOOLS_ENABLED` defined
+                                   (i.e., `godot-cpp` builds with `target=editor`)
 
     :raises ValueError:         If name is not a valid C++ identifier (valid identifier
                                 contains only [a-zA-Z0-9_] and cannot start with a number)
     :raises ValueError:         If no files are specified
+    :raises ValueError:         If `outputs` is not the same length as `files`, or `tool_classes`
+                                is not one of `"scene"`, `"editor"` or `"tools_enabled"`
     :raises FileExistsError:    If `output` is not set, `destination` folder does not exist,
                                 and `create_folders` is `False`
     :raises NotADirectoryError: If `output` is not set, and `destination` folder is a file
@@ -498,7 +2140,11 @@ def entry_point(name           : str,
             output = str(dest / (name+".lib.cpp"))
         else:
             output = name+".lib.cpp"
-    return _entry_point(name, files, output)
+    if outputs is not None and len(outputs) != len(files):
+        raise ValueError("The number of generated files does not match the number of files")
+    if tool_classes not in _TOOL_CLASSES:
+        raise ValueError("Unknown registration of tool classes: "+str(tool_classes))
+    return _entry_point(name, files, output, outputs, tool_classes)
 
 def entry_point_name(name : str) -> str:
     """
@@ -510,13 +2156,204 @@ def entry_point_name(name : str) -> str:
         raise ValueError("Specified name is not a valid C++ identifier: "+name)
     return '{0}_library_init'.format(name)
 
+def jumbo_outputs(name        : str,
+                  files       : list[str],
+                  jumbo       : int,
+                  destination : str|None = None) -> list[str]:
+    """
+    Gets the jumbo C++ source files (`<name>.jumbo<N>.cpp`) written by `write_jumbo` for the
+    generated C++ source files of the specified header files (see `generate_all`)
+
+    :param str name:             Name of the GDExtension
+    :param list[str] files:      List of C++ header (or generated) files
+    :param int jumbo:            The number of jumbo files requested (limited to the number of files)
+    :param str|None destination: Output directory for the jumbo files
+                                 (default = current working directory)
+
+    :return: List of the jumbo C++ source files
+    """
+    count = max(1, min(int(jumbo), len(files)))
+    outputs = ["{}.jumbo{}.cpp".format(name, index) for index in range(count)]
+    if destination:
+        outputs = [str(pathlib.Path(str(destination)) / x) for x in outputs]
+    return outputs
+
+def write_jumbo(generated : list[str], outputs : list[str]) -> list[str]:
+    """
+    Writes jumbo C++ source files, each including a share of the generated C++ source files, so
+    the generated code can be compiled as fewer translation units. The generated files are
+    balanced between the jumbo files by the number of bindings recorded in the manifest of each
+    generated file (largest first, each to the jumbo file with the fewest bindings so far), and
+    are included in their original order.
+
+    :param list[str] generated: List of the generated C++ source files (`<file>.gen.cpp`); any
+                                other files (e.g., the entry point) are not included
+    :param list[str] outputs:   List of the jumbo C++ source files to write
+
+    :return: The list of the C++ source files to compile; i.e., `outputs` followed by any
+             files from `generated` which are not `.gen.cpp` files
+    """
+    sources = [str(x) for x in generated if str(x).endswith(".gen.cpp")]
+    others = [str(x) for x in generated if not str(x).endswith(".gen.cpp")]
+
+    def bindings(source : str) -> int:
+        try:
+            with open(_manifest_path(source), encoding='utf-8') as f:
+                return int(json.load(f).get("bindings", 1))
+        except (OSError, ValueError, TypeError):
+            return 1
+
+    weights = [bindings(x) for x in sources]
+    totals = [0 for _ in outputs]
+    groups = [[] for _ in outputs]
+    for index in sorted(range(len(sources)), key=lambda x: weights[x], reverse=True):
+        target = min(range(len(outputs)), key=lambda x: totals[x])
+        totals[target] += weights[index]
+        groups[target].append(index)
+
+    for output,group in zip(outputs, groups):
+        folder = pathlib.Path(str(output)).absolute().parent
+        with _open_if_changed(str(output)) as f:
+            for index in sorted(group):
+                include = os.path.relpath(pathlib.Path(sources[index]).absolute(), folder)
+                f.write('#include "{}"\n'.format(pathlib.Path(include).as_posix()))
+    return [str(x) for x in outputs] + others
+
+_INTERFACE_TABLES = ["strings", "types", "classes", "methods", "arguments", "properties", "groups",
+                     "signals", "constants"]
+"""
+The tables of an interface dump, in the order of the file header (see `interfacedump.hpp`)
+"""
+
+_INTERFACE_RECORDS = {
+    "types": 4, "classes": 13, "methods": 5, "arguments": 4, "properties": 7, "groups": 4,
+    "signals": 3, "constants": 5
+}
+"""
+The number of 32-bit words in each record of the tables of an interface dump
+"""
+
+_INTERFACE_NONE = 0xFFFFFFFF
+
+def read_interface(path : str) -> dict:
+    """
+    Reads an interface dump written by the plugin (see `generate_all`), returning the same
+    structure as the JSON view of the interface
+
+    :param str path: Path to the interface dump (`<name>.gen.interface`)
+
+    :raises ValueError: If the file is not an interface dump, or is a different version
+    :raises OSError:    If the file cannot be read
+
+    :return: Dictionary containing the `version`, the `header` the interface was exported from,
+             and the `classes`; each with its `methods`, `properties`, `groups`, `signals` and
+             `constants`
+    """
+    with open(str(path), 'rb') as f:
+        data = f.read()
+    magic,version,size = struct.unpack_from("<4sII", data, 0) if len(data) >= 12 else (b"", 0, 0)
+    if magic != b"GDXI" or size != len(data):
+        raise ValueError("Not an interface dump: "+str(path))
+    if version != 1:
+        raise ValueError("Unsupported interface dump version {}: {}".format(version, path))
+    header = struct.unpack_from("<I", data, 12)[0]
+    offsets = struct.unpack_from("<{}I".format(2 * len(_INTERFACE_TABLES)), data, 16)
+    tables = {}
+    for index,table in enumerate(_INTERFACE_TABLES):
+        offset,count = offsets[2 * index],offsets[2 * index + 1]
+        if table == "strings":
+            strings = data[offset:offset + count]
+        else:
+            words = _INTERFACE_RECORDS[table]
+            tables[table] = [struct.unpack_from("<{}I".format(words), data, offset + 4 * words * x)
+                             for x in range(count)]
+
+    def string(offset : int) -> str|None:
+        if offset == _INTERFACE_NONE:
+            return None
+        return strings[offset:strings.index(b"\0", offset)].decode('utf-8')
+
+    def godot_type(index : int) -> dict|None:
+        if index == _INTERFACE_NONE:
+            return None
+        variant,type_name,enum_name,flags = tables["types"][index]
+        result = { "variant_type": string(variant), "type_name": string(type_name) }
+        if string(enum_name):
+            result["enum_name"] = string(enum_name)
+            result["is_bitfield"] = bool(flags & 1)
+        return result
+
+    def arguments(first : int, count : int) -> list[dict]:
+        result = []
+        for name,type_index,signature,default in tables["arguments"][first:first + count]:
+            argument = { "name": string(name), "type": godot_type(type_index), "signature": string(signature) }
+            if default != _INTERFACE_NONE:
+                argument["default"] = string(default)
+            result.append(argument)
+        return result
+
+    classes = []
+    kinds = { 1: "enum", 2: "bitfield", 3: "constants" }
+    for record in tables["classes"]:
+        def records(table : str, position : int) -> list[tuple]:
+            first,count = record[position:position + 2]
+            return tables[table][first:first + count]
+        classes.append({
+            "name": string(record[0]),
+            "qualified_name": string(record[1]),
+            "tool": bool(record[2] & 1),
+            "methods": [{ "name": string(name), "static": bool(flags & 1), "property": bool(flags & 2),
+                          "const": bool(flags & 4), "virtual": bool(flags & 8),
+                          "return_type": godot_type(return_type), "arguments": arguments(first, count) }
+                        for name,flags,return_type,first,count in records("methods", 3)],
+            "properties": [{ "name": string(name), "getter": string(getter), "setter": string(setter),
+                             "type": godot_type(type_index), "hint": string(hint),
+                             "hint_string": string(hint_string), "usage": string(usage) }
+                           for name,getter,setter,type_index,hint,hint_string,usage in records("properties", 5)],
+            "groups": [{ "name": string(name), "prefix": string(prefix), "subgroup": bool(flags & 1),
+                         "first_property": first }
+                       for name,prefix,flags,first in records("groups", 7)],
+            "signals": [{ "name": string(name), "arguments": arguments(first, count) }
+                        for name,first,count in records("signals", 9)],
+            "constants": [{ "name": string(name), "enum_name": string(enum_name), "kind": kinds.get(kind, "constants"),
+                            "value": struct.unpack("<q", struct.pack("<II", low, high))[0] }
+                          for name,enum_name,kind,low,high in records("constants", 11)]
+        })
+    return { "version": version, "header": string(header), "classes": classes }
+
+def _write_interface_index(path : str, headers : list[tuple[str,str]]):
+    """
+    Writes the index of the interface dumps of the header files (if changed); i.e., the interface
+    dump of each header which exports any classes, and the header (position in `headers`) exporting
+    each class, read from the manifest written for each generated file
+
+    :param str path:                     The index file to write
+    :param list[tuple[str,str]] headers: The header files, and the generated C++ source file for each
+    """
+    entries = []
+    classes = {}
+    for file,output in headers:
+        manifest = _read_manifest(output, file)
+        if not manifest or not manifest["classes"] or not os.path.exists(_interface_path(output)):
+            continue
+        for cls in manifest["classes"]:
+            classes[cls["name"]] = { "header": len(entries), "qualified_name": cls["qualified_name"],
+                                     "tool": cls["tool"] }
+        entries.append({ "header": str(file), "output": str(output), "interface": _interface_path(output) })
+    index = { "version": 1, "headers": entries, "classes": classes }
+    _write_if_changed(path, (json.dumps(index, indent=2)+'\n').encode('utf-8'))
+
 def list_doc_files(files          : list[str],
                    godot          : str|None  = 'godot-cpp',
                    clang          : str       = "clang",
                    sysincludes    : list[str] = [],
                    includes       : list[str] = [],
                    documentation  : str|None  = '',
-                   args           : list[str] = []) -> list[str]:
+                   args           : list[str] = [],
+                   pch            : str|None  = None,
+                   outputs        : list[str]|None = None,
+                   prescan        : bool      = False,
+                   modules        : str|None  = None) -> list[str]:
     """
     Gets the list of XML documentation files which will be generated for the specified input files.
 
@@ -535,6 +2372,19 @@ def list_doc_files(files          : list[str],
                                    Use `""` (empty string) or 'Non' to generate in default
                                    location (`doc_classes` in current working)
     :param list[str] args:         List of extra command line arguments to pass to clang
+    :param str|None pch:           Folder to store a precompiled header of the `godot-cpp` headers
+                                   in (see `generate_all`). If the precompiled header cannot be
+                                   built, the header files are processed without it
+    :param list[str]|None outputs: The C++ source file generated (or to be generated) for each of
+                                   the `files`. If specified, the manifest written when generating
+                                   each file is used (if the header file is unchanged), and clang is
+                                   only run for header files without an up-to-date manifest
+    :param bool prescan:           Specifies whether to check each header file for godot attributes,
+                                   by lexing it, and not run clang for header files without any
+                                   attributes (see `generate_all`)
+    :param str|None modules:       Folder to store a clang module cache of the `godot-cpp` headers
+                                   in (see `generate_all`). If the modules cannot be built, the
+                                   header files are processed without them
 
     :raises ValueError:         If no files are specified, or a specified file does not exist
 
@@ -549,33 +2399,47 @@ def list_doc_files(files          : list[str],
         if not filepath.exists():
             raise ValueError("Specified file does not exist: "+file)
 
-    version = _check_clang_version(clang)
-
     if not documentation:
         documentation = "doc_classes"
     dest = pathlib.Path(str(documentation))
 
+    names = [None] * len(files)
+    if outputs:
+        for index,(file,output) in enumerate(zip(files, outputs)):
+            manifest = _read_manifest(str(output), str(file))
+            if manifest is not None:
+                names[index] = [x["name"] for x in manifest["classes"]]
+    if prescan:
+        for index,file in enumerate(files):
+            if names[index] is None and not _has_godot_attributes(str(file)):
+                names[index] = []
+    if all(x is not None for x in names):
+        return [str(dest/(x+".xml")) for classes in names for x in classes]
+
+    _check_clang_version(clang)
     sysincludes = _load_godot_paths(godot, sysincludes)
+    try:
+        args = list(args) + _precompiled_header(pch, clang, sysincludes, includes, args)
+    except subprocess.CalledProcessError:
+        pass
+    if pch is None:
+        try:
+            args = list(args) + _module_cache(modules, clang, godot, sysincludes, includes, args)
+        except (subprocess.CalledProcessError, ValueError):
+            pass
 
-    result = []
     with _get_plugin_path() as library:
-        arguments = [str(clang), "-fsyntax-only", "-Xclang", "-std=c++17",
-                     "-Xclang", "-DGDEXPORT_GENERATING", "-fplugin="+str(library)]
-        for inc in sysincludes:
-            arguments += ["-Xclang", "-isystem", "-Xclang", str(inc)]
-        for inc in includes:
-            arguments += ["-Xclang", "-I", "-Xclang", str(inc)]
-        arguments += [y for x in args for y in ("-Xclang", str(x))]
-        arguments += [
-            "-Xclang", "-plugin-arg-gdexport", "-Xclang", "-nameonly"
-        ]
+        arguments = _compile_arguments(clang, sysincludes, includes, args)
+        arguments.append("-fplugin="+str(library))
+        arguments += _plugin_arguments("-nameonly")
         arguments.append("")
 
-        for file in files:
-            arguments[-1] = str(file)
-            output = subprocess.run(arguments, encoding='utf-8', capture_output=True)
-            result += [str(dest/(x.strip()+".xml")) for x in output.stdout.splitlines() if x.strip() != '']
-    return result
+        for index,file in enumerate(files):
+            if names[index] is None:
+                arguments[-1] = str(file)
+                output = subprocess.run(arguments, encoding='utf-8', capture_output=True)
+                names[index] = [x.strip() for x in output.stdout.splitlines() if x.strip() != '']
+    return [str(dest/(x+".xml")) for classes in names for x in classes]
 
 if __name__ == "__main__":
     import argparse
@@ -602,6 +2466,38 @@ if __name__ == "__main__":
                         help="Don't output informational status messages")
     parser.add_argument("--clang-arg", "-a", metavar="ARG", action="append", default=[],
                         help="Specifies that the next argument should be passed as an extra argument to clang")
+    # Always takes a value, so the option never consumes the name or a file (e.g., `--jobs src/a.hpp`)
+    parser.add_argument("--jobs", "-j", metavar="N", type=_jobs_argument, default=1,
+                        help="Number of clang processes to run in parallel ('auto' or 0 for the number of CPUs)")
+    # As for --jobs, the folders are required (`default` for the default folder)
+    parser.add_argument("--cache", metavar="DIR", type=_folder_argument, default=None,
+                        help="Specifies to cache generated files in the specified folder, and skip unchanged headers ('default' for .gdexport_cache)")
+    parser.add_argument("--pch", metavar="DIR", type=_folder_argument, default=None,
+                        help="Specifies to build, and use, a precompiled header of the godot-cpp headers in the specified folder ('default' for .gdexport_pch)")
+    parser.add_argument("--batch", "-b", action="store_true", default=False,
+                        help="Process several headers in each clang process (with the gdexport-batch driver)")
+    parser.add_argument("--prescan", action="store_true", default=False,
+                        help="Skip running clang for headers which contain no godot attributes")
+    parser.add_argument("--tables", action="store_true", default=False,
+                        help="Register properties and signals from constant tables rather than a call for each")
+    parser.add_argument("--thunks", action="store_true", default=False,
+                        help="Bind methods with generated call and ptrcall functions rather than MethodBind templates")
+    parser.add_argument("--jumbo", metavar="N", type=int, default=None,
+                        help="Include the generated files in N jumbo C++ source files, to compile as fewer translation units")
+    parser.add_argument("--doc-jobs", metavar="N", type=int, default=0,
+                        help="Write the XML documentation files for each header with N threads, once the header has been parsed")
+    parser.add_argument("--doc-budget", metavar="BYTES", type=int, default=None,
+                        help="Hold at most BYTES of XML documentation in memory for each header, moving the rest to temporary files")
+    parser.add_argument("--interface", action="store_true", default=False,
+                        help="Write a dump of the exported interface of each header, and an index of the dumps, for other tools to load")
+    parser.add_argument("--tool-classes", choices=_TOOL_CLASSES, default="scene",
+                        help="Register tool classes (and classes inheriting from them) with the other classes (scene, the default), at the editor initialization level (editor), or only in builds with TOOLS_ENABLED (tools_enabled)")
+    parser.add_argument("--stats", action="store_true", default=False,
+                        help="Record the time spent in each phase of processing each header, and print a summary table")
+    parser.add_argument("--compile-commands", metavar="PATH", default=None,
+                        help="Process the headers with the commands from a compilation database (compile_commands.json, or the build directory containing it), on N threads of one process")
+    parser.add_argument("--modules", metavar="DIR", type=_folder_argument, default=None,
+                        help="Specifies to build, and import, clang modules of the godot-cpp headers cached in the specified folder ('default' for .gdexport_modules)")
     parser.add_argument("name", help="Name of the GDExtension. Used for generating the entry_symbol name '<name>_library_init'")
     parser.add_argument("file", nargs='+', help="List of C++ header files to process to export Godot classes from")
     args = parser.parse_args()
@@ -627,7 +2523,22 @@ if __name__ == "__main__":
                         documentation = args.doc,
                         create_folders = args.make_dirs,
                         quiet = args.quiet,
-                        args = args.clang_arg)
+                        args = args.clang_arg,
+                        jobs = args.jobs,
+                        cache = args.cache,
+                        batch = args.batch,
+                        pch = args.pch,
+                        prescan = args.prescan,
+                        tables = args.tables,
+                        thunks = args.thunks,
+                        jumbo = args.jumbo,
+                        doc_jobs = args.doc_jobs,
+                        stats = args.stats,
+                        compile_commands = args.compile_commands,
+                        modules = args.modules,
+                        doc_budget = args.doc_budget,
+                        interface = args.interface,
+                        tool_classes = args.tool_classes)
     except ValueError as e:
         print('Unable to generate interface - {}'.format(e), file=sys.stderr)
     except FileExistsError as e:
@@ -0,0 +1,256 @@
+// SPDX-FileCopyrightText: 2025 Gridshadows Gaming <https://www.gridshadows.co.uk>
+// SPDX-License-Identifier: Zlib
+
+#ifndef GDEXPORT_INTERFACEDUMP_HPP
+#define GDEXPORT_INTERFACEDUMP_HPP
+
+// The format of the interface dump written for a header (see InterfaceDumpSink), for tools which
+// load the exported interface without running clang. Only depends on the standard library, so
+// it can be included by those tools.
+//
+// The file is little-endian, and every record is a sequence of 32-bit words (so the file can be
+// mapped, and the tables accessed in place, on a little-endian host). The file starts with a
+// DumpHeader, whose tables give the offset (in bytes, from the start of the file) and number of
+// records of each table. Each class refers to a contiguous range of each table (methods,
+// properties, etc.), and each method and signal to a contiguous range of the arguments.
+//
+// Strings are the offset (in bytes, from the start of the string table) of a NUL-terminated UTF-8
+// string; the string table starts with the empty string (so offset 0 is ""). Strings which may be
+// absent are DumpNone when absent, as are the indices of absent types.
+
+#include <cstdint>
+
+namespace gdexport
+{
+    /**
+     * The magic number at the start of an interface dump ("GDXI" in the file)
+     */
+    constexpr uint32_t DumpMagic = 0x49584447;
+
+    /**
+     * The version of the format, incremented on any incompatible change
+     */
+    constexpr uint32_t DumpVersion = 1;
+
+    /**
+     * An absent string or type
+     */
+    constexpr uint32_t DumpNone = 0xFFFFFFFF;
+
+    /**
+     * A table of records (or bytes, for the string table)
+     */
+    struct DumpTable
+    {
+        uint32_t Offset;
+        uint32_t Count;
+    };
+
+    /**
+     * A range of records of a table
+     */
+    struct DumpRange
+    {
+        uint32_t First;
+        uint32_t Count;
+    };
+
+    /**
+     * The header of the file
+     */
+    struct DumpHeader
+    {
+        uint32_t Magic;
+        uint32_t Version;
+        /**
+         * The size of the file in bytes
+         */
+        uint32_t Size;
+        /**
+         * The header file the interface was exported from
+         */
+        uint32_t Header;
+        DumpTable Strings;
+        DumpTable Types;
+        DumpTable Classes;
+        DumpTable Methods;
+        DumpTable Arguments;
+        DumpTable Properties;
+        DumpTable Groups;
+        DumpTable Signals;
+        DumpTable Constants;
+    };
+
+    /**
+     * A resolved godot type (see GodotType); each distinct type is written once
+     */
+    struct DumpType
+    {
+        enum : uint32_t
+        {
+            Bitfield = 1
+        };
+
+        /**
+         * The godot::Variant::Type value (as a fully-qualified C++ name)
+         */
+        uint32_t VariantType;
+        /**
+         * The godot class or builtin type name
+         */
+        uint32_t TypeName;
+        /**
+         * The name of the enum (or empty if not an enum)
+         */
+        uint32_t EnumName;
+        uint32_t Flags;
+    };
+
+    /**
+     * An exported class
+     */
+    struct DumpClass
+    {
+        enum : uint32_t
+        {
+            Tool = 1
+        };
+
+        uint32_t Name;
+        uint32_t QualifiedName;
+        uint32_t Flags;
+        DumpRange Methods;
+        DumpRange Properties;
+        DumpRange Groups;
+        DumpRange Signals;
+        DumpRange Constants;
+    };
+
+    /**
+     * A method (including property getters and setters) bound by the generated code
+     */
+    struct DumpMethod
+    {
+        enum : uint32_t
+        {
+            Static = 1,
+            Property = 2,
+            Const = 4,
+            Virtual = 8
+        };
+
+        uint32_t Name;
+        uint32_t Flags;
+        /**
+         * The index of the return type (or DumpNone for void)
+         */
+        uint32_t ReturnType;
+        DumpRange Arguments;
+    };
+
+    /**
+     * An argument of a method or signal
+     */
+    struct DumpArgument
+    {
+        uint32_t Name;
+        /**
+         * The index of the type
+         */
+        uint32_t Type;
+        /**
+         * The C++ declaration of the argument (raw source)
+         */
+        uint32_t Signature;
+        /**
+         * The default value (raw source), or DumpNone if none
+         */
+        uint32_t Default;
+    };
+
+    /**
+     * A property, in the order registered
+     */
+    struct DumpProperty
+    {
+        uint32_t Name;
+        uint32_t Getter;
+        uint32_t Setter;
+        /**
+         * The index of the type
+         */
+        uint32_t Type;
+        /**
+         * The godot::PropertyHint value (as a fully-qualified C++ name)
+         */
+        uint32_t Hint;
+        uint32_t HintString;
+        /**
+         * The godot::PropertyUsageFlags value (as C++ source)
+         */
+        uint32_t Usage;
+    };
+
+    /**
+     * A group or subgroup of properties
+     */
+    struct DumpGroup
+    {
+        enum : uint32_t
+        {
+            Subgroup = 1
+        };
+
+        uint32_t Name;
+        uint32_t Prefix;
+        uint32_t Flags;
+        /**
+         * The index (within the properties of the class) of the first property registered after
+         * the group
+         */
+        uint32_t FirstProperty;
+    };
+
+    /**
+     * A signal
+     */
+    struct DumpSignal
+    {
+        uint32_t Name;
+        DumpRange Arguments;
+    };
+
+    /**
+     * A constant of an enum, bitfield, or set of constants
+     */
+    struct DumpConstant
+    {
+        enum : uint32_t
+        {
+            Enum = 1,
+            Bitfield = 2,
+            Constants = 3
+        };
+
+        uint32_t Name;
+        /**
+         * The name of the enum declaring the constant
+         */
+        uint32_t EnumName;
+        uint32_t Kind;
+        uint32_t ValueLow;
+        uint32_t ValueHigh;
+
+        /**
+         * Gets the value of the constant
+         *
+         * @return The value
+         */
+        int64_t Value() const
+        {
+            return static_cast<int64_t>((static_cast<uint64_t>(ValueHigh) << 32) | ValueLow);
+        }
+    };
+}
+
+#endif // GDEXPORT_INTERFACEDUMP_HPP
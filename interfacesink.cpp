@@ -0,0 +1,575 @@
+// SPDX-FileCopyrightText: 2025 Gridshadows Gaming <https://www.gridshadows.co.uk>
+// SPDX-License-Identifier: Zlib
+
+#include "interfacesink.hpp"
+
+#include "interfacedump.hpp"
+#include "utilities.hpp"
+
+#include "clang/Basic/SourceManager.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/SHA256.h"
+
+#include <cstring>
+#include <filesystem>
+#include <type_traits>
+
+using namespace clang;
+
+void ClassNamesSink::ProcessStartClass(const ExportedClass& cls, CXXRecordDecl*)
+{
+    stream << cls.Name << "\n";
+}
+
+void ManifestSink::ProcessStartClass(const ExportedClass& cls, CXXRecordDecl*)
+{
+    classes.push_back(cls);
+}
+
+void ManifestSink::EndTranslationUnit(ASTContext& context)
+{
+    std::error_code err;
+    llvm::raw_fd_ostream file(manifest.Path, err, llvm::sys::fs::OF_Text);
+    if(err)
+    {
+        GenerateError(context, "Unable to open manifest file '%0': %1", manifest.Path, err.message());
+        return;
+    }
+    auto& sm = context.getSourceManager();
+    auto hash = llvm::SHA256::hash(llvm::arrayRefFromStringRef(sm.getBufferData(sm.getMainFileID())));
+    llvm::json::OStream json(file, 2);
+    json.object([&]
+        {
+            json.attribute("version", 1);
+            json.attribute("header", manifest.Header);
+            json.attribute("header_sha256", llvm::toHex(hash, true));
+            json.attribute("output", manifest.Output);
+            json.attribute("bindings", static_cast<int64_t>(bindings));
+            json.attributeArray("classes", [&]
+                {
+                    for(const auto& cls : classes)
+                    {
+                        json.object([&]
+                            {
+                                json.attribute("name", cls.Name);
+                                json.attribute("qualified_name", cls.QualifiedName);
+                                json.attribute("tool", cls.Tool);
+                                json.attribute("base", cls.Base);
+                                json.attribute("register", "register_" + manifest.Function + "_" + cls.Name);
+                                if(manifest.Documentation)
+                                {
+                                    json.attribute("documentation",
+                                        (std::filesystem::path(*manifest.Documentation) / (cls.Name + ".xml")).generic_string());
+                                }
+                            });
+                    }
+                });
+        });
+    file << '\n';
+}
+
+namespace
+{
+    /**
+     * Builds the string and type tables of the binary interface dump, and writes the records
+     */
+    class DumpBuilder
+    {
+    public:
+        DumpBuilder() : strings(StringRef("", 1)), offsets(), types(), indices()
+        {
+            offsets.try_emplace("", 0);
+        }
+
+        /**
+         * Gets the offset of a string in the string table, adding the string if not already added
+         *
+         * @param str The string
+         * @return The offset of the string
+         */
+        uint32_t String(StringRef str)
+        {
+            auto result = offsets.try_emplace(str, static_cast<uint32_t>(strings.size()));
+            if(result.second)
+            {
+                strings.append(str.begin(), str.end());
+                strings.push_back('\0');
+            }
+            return result.first->second;
+        }
+
+        /**
+         * Gets the offset of an optional string in the string table (see String)
+         *
+         * @param str The string
+         * @return The offset of the string, or DumpNone if empty
+         */
+        uint32_t OptionalString(const std::optional<std::string>& str)
+        {
+            return (str) ? String(*str) : ::gdexport::DumpNone;
+        }
+
+        /**
+         * Gets the index of a type in the type table, adding the type if not already added
+         *
+         * @param type The type
+         * @return The index of the type
+         */
+        uint32_t Type(const GodotType& type)
+        {
+            ::gdexport::DumpType record{String(type.VariantType), String(type.TypeName), String(type.EnumName),
+                (type.IsBitfield) ? ::gdexport::DumpType::Bitfield : 0u};
+            // The strings are unique, so the offsets identify the type
+            std::string key = llvm::utostr(record.VariantType) + ":" + llvm::utostr(record.TypeName) + ":"
+                + llvm::utostr(record.EnumName) + ":" + llvm::utostr(record.Flags);
+            auto result = indices.try_emplace(key, static_cast<uint32_t>(types.size()));
+            if(result.second)
+            {
+                types.push_back(record);
+            }
+            return result.first->second;
+        }
+
+        const llvm::SmallVectorImpl<char>& Strings() const { return strings; }
+        const std::vector<::gdexport::DumpType>& Types() const { return types; }
+
+        /**
+         * Append a record (as little-endian 32-bit words) to a buffer
+         *
+         * @param buffer The buffer to append to
+         * @param record The record
+         */
+        template<class T>
+        static void Append(llvm::SmallVectorImpl<char>& buffer, const T& record)
+        {
+            static_assert(std::is_trivially_copyable_v<T> && (sizeof(T) % sizeof(uint32_t) == 0),
+                "interface dump records must be 32-bit words");
+            uint32_t words[sizeof(T) / sizeof(uint32_t)];
+            std::memcpy(words, &record, sizeof(T));
+            for(auto word : words)
+            {
+                char bytes[sizeof(uint32_t)];
+                llvm::support::endian::write32le(bytes, word);
+                buffer.append(bytes, bytes + sizeof(uint32_t));
+            }
+        }
+
+        /**
+         * Append a table of records to a buffer
+         *
+         * @param buffer The buffer to append to
+         * @param records The records
+         * @return The offset and number of records of the table
+         */
+        template<class T>
+        static ::gdexport::DumpTable AppendTable(llvm::SmallVectorImpl<char>& buffer, const std::vector<T>& records)
+        {
+            ::gdexport::DumpTable table{static_cast<uint32_t>(buffer.size()), static_cast<uint32_t>(records.size())};
+            for(const auto& record : records)
+            {
+                Append(buffer, record);
+            }
+            return table;
+        }
+
+    private:
+        llvm::SmallString<0> strings;
+        llvm::StringMap<uint32_t> offsets;
+        std::vector<::gdexport::DumpType> types;
+        llvm::StringMap<uint32_t> indices;
+    };
+
+    /**
+     * Gets the range of the records appended to a table since the first record
+     *
+     * @param records The records of the table
+     * @param first The number of records before appending
+     * @return The range of the appended records
+     */
+    template<class T>
+    ::gdexport::DumpRange RangeFrom(const std::vector<T>& records, std::size_t first)
+    {
+        return ::gdexport::DumpRange{static_cast<uint32_t>(first), static_cast<uint32_t>(records.size() - first)};
+    }
+
+    void WriteType(llvm::json::OStream& json, const GodotType& type)
+    {
+        json.object([&]
+            {
+                json.attribute("variant_type", type.VariantType);
+                json.attribute("type_name", type.TypeName);
+                if(!type.EnumName.empty())
+                {
+                    json.attribute("enum_name", type.EnumName);
+                    json.attribute("is_bitfield", type.IsBitfield);
+                }
+            });
+    }
+
+    llvm::StringRef ConstantKind(InterfaceSink::ConstantType type)
+    {
+        switch(type)
+        {
+        case InterfaceSink::ConstantType::Enum:
+            return "enum";
+        case InterfaceSink::ConstantType::Bitfield:
+            return "bitfield";
+        case InterfaceSink::ConstantType::Constants:
+        case InterfaceSink::ConstantType::None:
+        default:
+            return "constants";
+        }
+    }
+}
+
+void InterfaceDumpSink::ProcessStartClass(const ExportedClass& cls, CXXRecordDecl*)
+{
+    classes.push_back(ClassInfo{cls, {}, {}, {}, {}, {}});
+    current = true;
+}
+
+void InterfaceDumpSink::ProcessGroup(const StringRef& name, const StringRef& prefix, bool subgroup)
+{
+    if(current)
+    {
+        auto& cls = classes.back();
+        cls.Groups.push_back(GroupInfo{name.str(), prefix.str(), subgroup, cls.Properties.size()});
+    }
+}
+
+void InterfaceDumpSink::ProcessSignal(const StringRef& name, CXXMethodDecl*,
+    const std::vector<FunctionArgument>& arguments)
+{
+    if(current)
+    {
+        classes.back().Signals.push_back(SignalInfo{name.str(), CopyArguments(arguments)});
+    }
+}
+
+void InterfaceDumpSink::ProcessProperty(const StringRef& name, const Property& property)
+{
+    if(current)
+    {
+        classes.back().Properties.push_back(PropertyInfo{name.str(), property});
+    }
+}
+
+void InterfaceDumpSink::ProcessMethod(const StringRef& name, CXXMethodDecl* declaration, bool isStatic,
+    bool isProperty, const std::vector<FunctionArgument>& arguments, const std::optional<GodotType>& returnType)
+{
+    if(!current)
+    {
+        return;
+    }
+    uint32_t flags = 0;
+    if(isStatic)
+    {
+        flags |= ::gdexport::DumpMethod::Static;
+    }
+    if(isProperty)
+    {
+        flags |= ::gdexport::DumpMethod::Property;
+    }
+    if(declaration->isConst())
+    {
+        flags |= ::gdexport::DumpMethod::Const;
+    }
+    if(declaration->isVirtual())
+    {
+        flags |= ::gdexport::DumpMethod::Virtual;
+    }
+    classes.back().Methods.push_back(MethodInfo{name.str(), flags, returnType, CopyArguments(arguments)});
+}
+
+void InterfaceDumpSink::ProcessConstant(ConstantType type, const StringRef& name, EnumConstantDecl* declaration)
+{
+    if(!current)
+    {
+        return;
+    }
+    StringRef enumName;
+    if(auto enumType = dyn_cast<clang::EnumDecl>(declaration->getDeclContext()))
+    {
+        enumName = enumType->getName();
+    }
+    // Extended according to the signedness of the enum, so unsigned values above INT64_MAX keep
+    // their bit pattern (getExtValue is only valid for values which fit in an int64_t)
+    const auto& value = declaration->getInitVal();
+    classes.back().Constants.push_back(ConstantInfo{name.str(), enumName.str(), type,
+        (value.isUnsigned()) ? static_cast<int64_t>(value.getZExtValue()) : value.getSExtValue()});
+}
+
+std::vector<InterfaceDumpSink::ArgumentInfo> InterfaceDumpSink::CopyArguments(
+    const std::vector<FunctionArgument>& arguments)
+{
+    std::vector<ArgumentInfo> result;
+    result.reserve(arguments.size());
+    for(const auto& arg : arguments)
+    {
+        std::optional<std::string> defaultVal;
+        if(arg.Default)
+        {
+            defaultVal = arg.Default->str();
+        }
+        result.push_back(ArgumentInfo{arg.Name.str(), arg.Type, arg.Signature.str(), std::move(defaultVal)});
+    }
+    return result;
+}
+
+void InterfaceDumpSink::EndTranslationUnit(ASTContext& context)
+{
+    llvm::SmallString<0> content;
+    llvm::raw_svector_ostream os(content);
+    if(StringRef(dumpPath).ends_with_insensitive(".json"))
+    {
+        WriteJSON(os);
+    }
+    else
+    {
+        WriteBinary(os);
+    }
+    auto err = WriteFileIfChanged(dumpPath, content);
+    if(err)
+    {
+        GenerateError(context, "Unable to write interface file '%0': %1", dumpPath, err.message());
+    }
+}
+
+void InterfaceDumpSink::WriteBinary(llvm::raw_ostream& os) const
+{
+    DumpBuilder builder;
+    std::vector<::gdexport::DumpClass> classRecords;
+    std::vector<::gdexport::DumpMethod> methods;
+    std::vector<::gdexport::DumpArgument> arguments;
+    std::vector<::gdexport::DumpProperty> properties;
+    std::vector<::gdexport::DumpGroup> groups;
+    std::vector<::gdexport::DumpSignal> signals;
+    std::vector<::gdexport::DumpConstant> constants;
+    auto addArguments = [&](const std::vector<ArgumentInfo>& args)
+        {
+            auto first = arguments.size();
+            for(const auto& arg : args)
+            {
+                arguments.push_back(::gdexport::DumpArgument{builder.String(arg.Name), builder.Type(arg.Type),
+                    builder.String(arg.Signature), builder.OptionalString(arg.Default)});
+            }
+            return RangeFrom(arguments, first);
+        };
+    uint32_t header = builder.String(headerFile);
+    for(const auto& cls : classes)
+    {
+        ::gdexport::DumpClass record{builder.String(cls.Class.Name), builder.String(cls.Class.QualifiedName),
+            (cls.Class.Tool) ? ::gdexport::DumpClass::Tool : 0u, {}, {}, {}, {}, {}};
+
+        auto first = methods.size();
+        for(const auto& method : cls.Methods)
+        {
+            auto returnType = (method.ReturnType) ? builder.Type(*method.ReturnType) : ::gdexport::DumpNone;
+            auto range = addArguments(method.Arguments);
+            methods.push_back(::gdexport::DumpMethod{builder.String(method.Name), method.Flags, returnType, range});
+        }
+        record.Methods = RangeFrom(methods, first);
+
+        first = properties.size();
+        for(const auto& property : cls.Properties)
+        {
+            const auto& info = property.Info;
+            properties.push_back(::gdexport::DumpProperty{builder.String(property.Name), builder.String(info.Getter),
+                builder.String(info.Setter), builder.Type(info.Type), builder.String(info.Hint),
+                builder.String(info.HintString), builder.String(info.Usage)});
+        }
+        record.Properties = RangeFrom(properties, first);
+
+        first = groups.size();
+        for(const auto& group : cls.Groups)
+        {
+            groups.push_back(::gdexport::DumpGroup{builder.String(group.Name), builder.String(group.Prefix),
+                (group.Subgroup) ? ::gdexport::DumpGroup::Subgroup : 0u, static_cast<uint32_t>(group.FirstProperty)});
+        }
+        record.Groups = RangeFrom(groups, first);
+
+        first = signals.size();
+        for(const auto& signal : cls.Signals)
+        {
+            auto name = builder.String(signal.Name);
+            signals.push_back(::gdexport::DumpSignal{name, addArguments(signal.Arguments)});
+        }
+        record.Signals = RangeFrom(signals, first);
+
+        first = constants.size();
+        for(const auto& constant : cls.Constants)
+        {
+            uint32_t kind = ::gdexport::DumpConstant::Constants;
+            if(constant.Type == ConstantType::Enum)
+            {
+                kind = ::gdexport::DumpConstant::Enum;
+            }
+            else if(constant.Type == ConstantType::Bitfield)
+            {
+                kind = ::gdexport::DumpConstant::Bitfield;
+            }
+            auto value = static_cast<uint64_t>(constant.Value);
+            constants.push_back(::gdexport::DumpConstant{builder.String(constant.Name),
+                builder.String(constant.EnumName), kind, static_cast<uint32_t>(value),
+                static_cast<uint32_t>(value >> 32)});
+        }
+        record.Constants = RangeFrom(constants, first);
+
+        classRecords.push_back(record);
+    }
+
+    // The header is written last, once the offsets of the tables are known
+    ::gdexport::DumpHeader fileHeader{};
+    llvm::SmallString<0> buffer;
+    buffer.resize(sizeof(fileHeader));
+    fileHeader.Magic = ::gdexport::DumpMagic;
+    fileHeader.Version = ::gdexport::DumpVersion;
+    fileHeader.Header = header;
+    fileHeader.Types = DumpBuilder::AppendTable(buffer, builder.Types());
+    fileHeader.Classes = DumpBuilder::AppendTable(buffer, classRecords);
+    fileHeader.Methods = DumpBuilder::AppendTable(buffer, methods);
+    fileHeader.Arguments = DumpBuilder::AppendTable(buffer, arguments);
+    fileHeader.Properties = DumpBuilder::AppendTable(buffer, properties);
+    fileHeader.Groups = DumpBuilder::AppendTable(buffer, groups);
+    fileHeader.Signals = DumpBuilder::AppendTable(buffer, signals);
+    fileHeader.Constants = DumpBuilder::AppendTable(buffer, constants);
+    const auto& strings = builder.Strings();
+    fileHeader.Strings = ::gdexport::DumpTable{static_cast<uint32_t>(buffer.size()), static_cast<uint32_t>(strings.size())};
+    buffer.append(strings.begin(), strings.end());
+    // Padded, so the file is a whole number of words
+    buffer.resize(llvm::alignTo(buffer.size(), sizeof(uint32_t)), '\0');
+    fileHeader.Size = static_cast<uint32_t>(buffer.size());
+
+    llvm::SmallString<sizeof(fileHeader)> headerBytes;
+    DumpBuilder::Append(headerBytes, fileHeader);
+    std::memcpy(buffer.data(), headerBytes.data(), headerBytes.size());
+    os << buffer;
+}
+
+void InterfaceDumpSink::WriteJSON(llvm::raw_ostream& os) const
+{
+    llvm::json::OStream json(os, 2);
+    auto writeArguments = [&json](const std::vector<ArgumentInfo>& args)
+        {
+            json.attributeArray("arguments", [&]
+                {
+                    for(const auto& arg : args)
+                    {
+                        json.object([&]
+                            {
+                                json.attribute("name", arg.Name);
+                                json.attributeBegin("type");
+                                WriteType(json, arg.Type);
+                                json.attributeEnd();
+                                json.attribute("signature", arg.Signature);
+                                if(arg.Default)
+                                {
+                                    json.attribute("default", *arg.Default);
+                                }
+                            });
+                    }
+                });
+        };
+    json.object([&]
+        {
+            json.attribute("version", static_cast<int64_t>(::gdexport::DumpVersion));
+            json.attribute("header", headerFile);
+            json.attributeArray("classes", [&]
+                {
+                    for(const auto& cls : classes)
+                    {
+                        json.object([&]
+                            {
+                                json.attribute("name", cls.Class.Name);
+                                json.attribute("qualified_name", cls.Class.QualifiedName);
+                                json.attribute("tool", cls.Class.Tool);
+                                json.attributeArray("methods", [&]
+                                    {
+                                        for(const auto& method : cls.Methods)
+                                        {
+                                            json.object([&]
+                                                {
+                                                    json.attribute("name", method.Name);
+                                                    json.attribute("static", (method.Flags & ::gdexport::DumpMethod::Static) != 0);
+                                                    json.attribute("property", (method.Flags & ::gdexport::DumpMethod::Property) != 0);
+                                                    json.attribute("const", (method.Flags & ::gdexport::DumpMethod::Const) != 0);
+                                                    json.attribute("virtual", (method.Flags & ::gdexport::DumpMethod::Virtual) != 0);
+                                                    json.attributeBegin("return_type");
+                                                    if(method.ReturnType)
+                                                    {
+                                                        WriteType(json, *method.ReturnType);
+                                                    }
+                                                    else
+                                                    {
+                                                        json.value(nullptr);
+                                                    }
+                                                    json.attributeEnd();
+                                                    writeArguments(method.Arguments);
+                                                });
+                                        }
+                                    });
+                                json.attributeArray("properties", [&]
+                                    {
+                                        for(const auto& property : cls.Properties)
+                                        {
+                                            json.object([&]
+                                                {
+                                                    json.attribute("name", property.Name);
+                                                    json.attribute("getter", property.Info.Getter);
+                                                    json.attribute("setter", property.Info.Setter);
+                                                    json.attributeBegin("type");
+                                                    WriteType(json, property.Info.Type);
+                                                    json.attributeEnd();
+                                                    json.attribute("hint", property.Info.Hint);
+                                                    json.attribute("hint_string", property.Info.HintString);
+                                                    json.attribute("usage", property.Info.Usage);
+                                                });
+                                        }
+                                    });
+                                json.attributeArray("groups", [&]
+                                    {
+                                        for(const auto& group : cls.Groups)
+                                        {
+                                            json.object([&]
+                                                {
+                                                    json.attribute("name", group.Name);
+                                                    json.attribute("prefix", group.Prefix);
+                                                    json.attribute("subgroup", group.Subgroup);
+                                                    json.attribute("first_property", static_cast<int64_t>(group.FirstProperty));
+                                                });
+                                        }
+                                    });
+                                json.attributeArray("signals", [&]
+                                    {
+                                        for(const auto& signal : cls.Signals)
+                                        {
+                                            json.object([&]
+                                                {
+                                                    json.attribute("name", signal.Name);
+                                                    writeArguments(signal.Arguments);
+                                                });
+                                        }
+                                    });
+                                json.attributeArray("constants", [&]
+                                    {
+                                        for(const auto& constant : cls.Constants)
+                                        {
+                                            json.object([&]
+                                                {
+                                                    json.attribute("name", constant.Name);
+                                                    json.attribute("enum_name", constant.EnumName);
+                                                    json.attribute("kind", ConstantKind(constant.Type));
+                                                    json.attribute("value", constant.Value);
+                                                });
+                                        }
+                                    });
+                            });
+                    }
+                });
+        });
+    os << '\n';
+}
@@ -0,0 +1,332 @@
+// SPDX-FileCopyrightText: 2025 Gridshadows Gaming <https://www.gridshadows.co.uk>
+// SPDX-License-Identifier: Zlib
+
+#ifndef GDEXPORT_INTERFACESINK_HPP
+#define GDEXPORT_INTERFACESINK_HPP
+
+#include "extractinterfacevisitor.hpp"
+
+#include "llvm/Support/raw_ostream.h"
+
+#include <optional>
+#include <string>
+#include <vector>
+
+using namespace clang;
+
+/**
+ * Receives the godot classes, methods, properties, etc. decoded by an ExtractInterfaceVisitor.
+ *
+ * Sinks are added to the visitor (see ExtractInterfaceVisitor::AddSink), so that several outputs
+ * can be generated from a single traversal of the AST, with the attributes and types decoded
+ * only once. The Process* methods are called (in the same order) after the corresponding
+ * Process* methods of the visitor; the default implementations do nothing.
+ */
+class InterfaceSink
+{
+public:
+    typedef ExtractInterfaceVisitor::ExportedClass ExportedClass;
+    typedef ExtractInterfaceVisitor::Property Property;
+    typedef ExtractInterfaceVisitor::FunctionArgument FunctionArgument;
+    typedef ExtractInterfaceVisitor::ConstantType ConstantType;
+
+    virtual ~InterfaceSink() = default;
+
+    /**
+     * Called when a class marked with `[[godot::class]]` or `[[godot::tool]]` is encountered
+     *
+     * @param cls The exported class
+     * @param declaration The declaration for the class
+     */
+    virtual void ProcessStartClass(const ExportedClass& cls, CXXRecordDecl* declaration) { }
+
+    /**
+     * Called when reaching the end of the definition of an exported class
+     *
+     * @param cls The exported class
+     * @param declaration The declaration for the class
+     */
+    virtual void ProcessEndClass(const ExportedClass& cls, CXXRecordDecl* declaration) { }
+
+    /**
+     * Called when a `[[godot::group]]` or `[[godot::subgroup]]` attribute is encountered
+     *
+     * @param name The name of the group
+     * @param prefix The prefix required for members to be part of the group
+     * @param subgroup true if a subgroup; false if a group
+     */
+    virtual void ProcessGroup(const StringRef& name, const StringRef& prefix, bool subgroup) { }
+
+    /**
+     * Called when encountering a method marked with `[[godot::signal]]`
+     *
+     * @param name The name of the signal
+     * @param declaration The declaration of the method
+     * @param arguments The arguments to the method
+     */
+    virtual void ProcessSignal(const StringRef& name, CXXMethodDecl* declaration,
+        const std::vector<FunctionArgument>& arguments) { }
+
+    /**
+     * Called when the (complete) information for a property is available
+     *
+     * @param name The name of the property
+     * @param property Information about the property
+     */
+    virtual void ProcessProperty(const StringRef& name, const Property& property) { }
+
+    /**
+     * Called when encountering a method marked with `[[godot::getter]]`, `[[godot::setter]]` or
+     * `[[godot::method]]`
+     *
+     * @param name The name of the method
+     * @param declaration The declaration of the method
+     * @param isStatic true if the method is a static method; false if an instance method
+     * @param isProperty true if the function is a property getter/setter; false if normal method
+     * @param arguments The arguments to the method
+     * @param returnType Optional information about the return type of the method
+     */
+    virtual void ProcessMethod(const StringRef& name, CXXMethodDecl* declaration, bool isStatic,
+        bool isProperty, const std::vector<FunctionArgument>& arguments,
+        const std::optional<GodotType>& returnType) { }
+
+    /**
+     * Called when encountering an enum value declaration of an enum marked `[[godot::enum]]`,
+     * `[[godot::bitfield]]` or `[[godot::constants]]`
+     *
+     * @param type The type of the enum
+     * @param name The name of the enum constant
+     * @param declaration The declaration of the enum constant
+     */
+    virtual void ProcessConstant(ConstantType type, const StringRef& name, EnumConstantDecl* declaration) { }
+
+    /**
+     * Called once the whole translation unit has been traversed
+     *
+     * @param context The AST context
+     */
+    virtual void EndTranslationUnit(ASTContext& context) { }
+};
+
+/**
+ * Sink which prints the name of each exported class on a separate line (used to generate the list
+ * of XML documentation files which will be generated)
+ */
+class ClassNamesSink : public InterfaceSink
+{
+public:
+    /**
+     * Create the sink
+     *
+     * @param os The stream to print the class names to
+     */
+    ClassNamesSink(llvm::raw_ostream& os) : stream(os) { }
+
+    virtual void ProcessStartClass(const ExportedClass& cls, CXXRecordDecl* declaration) override;
+
+private:
+    llvm::raw_ostream& stream;
+};
+
+/**
+ * Details of the files generated for a header, written to the manifest
+ */
+struct Manifest
+{
+    /**
+     * The manifest file to write
+     */
+    std::string Path;
+    /**
+     * The header file processed
+     */
+    std::string Header;
+    /**
+     * The file the generated code is written to
+     */
+    std::string Output;
+    /**
+     * The name (derived from the header) of the functions of the generated code which register
+     * the classes
+     */
+    std::string Function;
+    /**
+     * The folder the XML documentation is written to (if generating documentation)
+     */
+    std::optional<std::string> Documentation;
+};
+
+/**
+ * Sink which writes the manifest (as JSON) for the processed header, containing the generated
+ * files, the classes exported from the header, and the number of bindings (methods, properties,
+ * signals, etc.) registered by the generated code (used to balance jumbo translation units)
+ */
+class ManifestSink : public InterfaceSink
+{
+public:
+    /**
+     * Create the sink
+     *
+     * @param details The details of the generated files to write to the manifest
+     */
+    ManifestSink(Manifest&& details) : manifest(std::move(details)), classes(), bindings(0) { }
+
+    virtual void ProcessStartClass(const ExportedClass& cls, CXXRecordDecl* declaration) override;
+    virtual void ProcessGroup(const StringRef& name, const StringRef& prefix, bool subgroup) override
+    {
+        ++bindings;
+    }
+    virtual void ProcessSignal(const StringRef& name, CXXMethodDecl* declaration,
+        const std::vector<FunctionArgument>& arguments) override
+    {
+        ++bindings;
+    }
+    virtual void ProcessProperty(const StringRef& name, const Property& property) override
+    {
+        ++bindings;
+    }
+    virtual void ProcessMethod(const StringRef& name, CXXMethodDecl* declaration, bool isStatic,
+        bool isProperty, const std::vector<FunctionArgument>& arguments,
+        const std::optional<GodotType>& returnType) override
+    {
+        ++bindings;
+    }
+    virtual void ProcessConstant(ConstantType type, const StringRef& name, EnumConstantDecl* declaration) override
+    {
+        ++bindings;
+    }
+    virtual void EndTranslationUnit(ASTContext& context) override;
+
+private:
+    Manifest manifest;
+    std::vector<ExportedClass> classes;
+    std::size_t bindings;
+};
+
+/**
+ * Sink which writes the whole exported interface of the processed header (classes, methods and
+ * their arguments, properties, groups, signals and constants, with the resolved godot types), so
+ * other tools can load the interface without running clang. Writes the binary format described in
+ * interfacedump.hpp, or a JSON view of the same interface if the file has a `.json` extension.
+ */
+class InterfaceDumpSink : public InterfaceSink
+{
+public:
+    /**
+     * Create the sink
+     *
+     * @param path The file to write
+     * @param header The header file processed
+     */
+    InterfaceDumpSink(const std::string& path, const std::string& header)
+        : dumpPath(path), headerFile(header), classes(), current(false)
+    {
+    }
+
+    virtual void ProcessStartClass(const ExportedClass& cls, CXXRecordDecl* declaration) override;
+    virtual void ProcessEndClass(const ExportedClass& cls, CXXRecordDecl* declaration) override
+    {
+        current = false;
+    }
+    virtual void ProcessGroup(const StringRef& name, const StringRef& prefix, bool subgroup) override;
+    virtual void ProcessSignal(const StringRef& name, CXXMethodDecl* declaration,
+        const std::vector<FunctionArgument>& arguments) override;
+    virtual void ProcessProperty(const StringRef& name, const Property& property) override;
+    virtual void ProcessMethod(const StringRef& name, CXXMethodDecl* declaration, bool isStatic,
+        bool isProperty, const std::vector<FunctionArgument>& arguments,
+        const std::optional<GodotType>& returnType) override;
+    virtual void ProcessConstant(ConstantType type, const StringRef& name, EnumConstantDecl* declaration) override;
+    virtual void EndTranslationUnit(ASTContext& context) override;
+
+private:
+    /**
+     * An argument of a method or signal (copied, as the arguments do not outlive the call)
+     */
+    struct ArgumentInfo
+    {
+        std::string Name;
+        GodotType Type;
+        std::string Signature;
+        std::optional<std::string> Default;
+    };
+
+    struct MethodInfo
+    {
+        std::string Name;
+        uint32_t Flags;
+        std::optional<GodotType> ReturnType;
+        std::vector<ArgumentInfo> Arguments;
+    };
+
+    struct PropertyInfo
+    {
+        std::string Name;
+        Property Info;
+    };
+
+    struct GroupInfo
+    {
+        std::string Name;
+        std::string Prefix;
+        bool Subgroup;
+        std::size_t FirstProperty;
+    };
+
+    struct SignalInfo
+    {
+        std::string Name;
+        std::vector<ArgumentInfo> Arguments;
+    };
+
+    struct ConstantInfo
+    {
+        std::string Name;
+        std::string EnumName;
+        ConstantType Type;
+        int64_t Value;
+    };
+
+    struct ClassInfo
+    {
+        ExportedClass Class;
+        std::vector<MethodInfo> Methods;
+        std::vector<PropertyInfo> Properties;
+        std::vector<GroupInfo> Groups;
+        std::vector<SignalInfo> Signals;
+        std::vector<ConstantInfo> Constants;
+    };
+
+    /**
+     * Copy the arguments of a method or signal
+     *
+     * @param arguments The arguments
+     * @return The copied arguments
+     */
+    static std::vector<ArgumentInfo> CopyArguments(const std::vector<FunctionArgument>& arguments);
+
+    /**
+     * Write the interface in the binary format (see interfacedump.hpp)
+     *
+     * @param os The stream to write to
+     */
+    void WriteBinary(llvm::raw_ostream& os) const;
+
+    /**
+     * Write the interface as JSON
+     *
+     * @param os The stream to write to
+     */
+    void WriteJSON(llvm::raw_ostream& os) const;
+
+    std::string dumpPath;
+    std::string headerFile;
+    std::vector<ClassInfo> classes;
+
+    /**
+     * Specifies whether the last of the classes is the current class (i.e., between the start and
+     * end of the class), to which the methods, properties, etc. are added
+     */
+    bool current;
+};
+
+#endif // GDEXPORT_INTERFACESINK_HPP
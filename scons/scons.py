@@ -20,6 +20,8 @@ __status__ = "Development"
 
 from .. import gdexport
 from SCons.Builder import Builder
+from SCons.Scanner import Scanner
+import os
 import pathlib
 
 def configure_generate(env,
@@ -31,11 +33,26 @@ def configure_generate(env,
                        includes       : list[str]      = [],
                        destination    : str|None       = None,
                        documentation  : str|None       = None,
-                       args           : list[str]      = []):
+                       args           : list[str]      = [],
+                       pch            : str|None       = None,
+                       server         : bool           = False,
+                       prescan        : bool           = False,
+                       tables         : bool           = False,
+                       thunks         : bool           = False,
+                       jumbo          : int|None       = None,
+                       doc_jobs       : int            = 0,
+                       modules        : str|None       = None,
+                       doc_budget     : int|None       = None,
+                       interface      : bool           = False,
+                       tool_classes   : str            = "scene"):
     """
     Create SCon builders and add build steps to generate C++ files to perform the necessary export
     for GDExension for the specified C++ header files.
 
+    A dependency file is written alongside each generated file (see `gdexport.export_header`),
+    which the builder scans for the files included by the header, so the file is only regenerated
+    when the header, or a file it includes, changes.
+
     :param: SCons.Environment env: The SCons environment to add the builders to
     :param str name:               Name of the GDExtension. Used for generating
                                    the "entry_symbol" function name (`<name>_library_init`)
@@ -64,6 +81,43 @@ def configure_generate(env,
                                    location (`doc_classes` in current working),
                                    or path to directory to generate in otherwise
     :param list[str] args:         List of extra command line arguments to pass to clang
+    :param str|None pch:           Folder to store a precompiled header of the `godot-cpp` headers
+                                   in, which is built once and used when processing each header file.
+                                   Specify `None` to not use a precompiled header, `""` (empty
+                                   string) to use the default location (`.gdexport_pch` in the
+                                   current working directory), or path to directory otherwise
+    :param bool server:            Specifies whether to process the header files with long-lived
+                                   server processes (see `gdexport.export_header`), rather than
+                                   starting clang for each header file
+    :param bool prescan:           Specifies whether to check each header file for godot attributes,
+                                   by lexing it, and not run clang for header files without any
+                                   attributes (see `gdexport.generate_all`)
+    :param bool tables:            Specifies whether to register the properties and signals from
+                                   constant tables (see `gdexport.generate_all`)
+    :param bool thunks:            Specifies whether to bind the methods with generated call and
+                                   ptrcall functions (see `gdexport.generate_all`)
+    :param int|None jumbo:         Number of jumbo C++ source files to include the generated files
+                                   in, which are returned instead of the generated files (see
+                                   `gdexport.generate_all`). `None` to not use jumbo files
+    :param int doc_jobs:           Number of threads to write the XML documentation files for each
+                                   header with (see `gdexport.generate_all`)
+    :param str|None modules:       Folder to store a clang module cache of the `godot-cpp` headers
+                                   in, which is shared by every header file (and every build), so
+                                   each `godot-cpp` header is only parsed once (see
+                                   `gdexport.generate_all`). `None` to not use modules. Cannot be
+                                   used with `pch`
+    :param int|None doc_budget:    Number of bytes of XML documentation to hold in memory for each
+                                   header (see `gdexport.generate_all`). `None` to keep the parsed
+                                   documentation of each class in memory
+    :param bool interface:         Specifies whether to write a dump of the exported interface
+                                   alongside each generated file (`<name>.gen.interface`; see
+                                   `gdexport.read_interface`)
+    :param str tool_classes:       How to register the classes marked with `[[godot::tool]]`, and
+                                   the classes inheriting from them: `"scene"` (the default),
+                                   `"editor"` or `"tools_enabled"` (see `gdexport.entry_point`).
+                                   The entry point is rebuilt when any generated file changes, as
+                                   the classes are registered from the plan read from the manifest
+                                   of each generated file
 
     :raises ValueError:         If name is not a valid C++ identifier (valid identifier
                                 contains only [a-zA-Z0-9_] and cannot start with a number)
@@ -97,23 +151,47 @@ def configure_generate(env,
         documentation = "doc_classes"
     if documentation and (env["target"] in ["editor", "template_debug"]):
         def doc_emitter_func(env, target, source):
+            # Uses the manifest from any previous generation of the target, to avoid parsing
+            # unchanged headers again
             target += gdexport.list_doc_files(source, godot, clang, sysincludes,
-                                              includes, documentation, args)
+                                              includes, documentation, args, pch,
+                                              outputs=[str(x) for x in target], prescan=prescan,
+                                              modules=modules)
             return target,source
         doc_emitter = doc_emitter_func
 
     def gdexport_entry_point(env,target,source):
-        gdexport.entry_point(name, source, target[0])
+        gdexport.entry_point(name, [str(x) for x in source], str(target[0]),
+                             outputs=[str(x) for x in generated], tool_classes=tool_classes)
 
     def gdexport_export_header(env,target,source):
         gdexport.export_header(source[0], output=target[0], godot=godot, clang=clang,
                                sysincludes=sysincludes, includes=includes,
-                               documentation=documentation, create_folders=True, args=args)
+                               documentation=documentation, create_folders=True, args=args,
+                               pch=pch, server=server, prescan=prescan, tables=tables,
+                               thunks=thunks, doc_jobs=doc_jobs, dependencies=True,
+                               modules=modules, doc_budget=doc_budget,
+                               interface=interface)
+
+    def gdexport_scan_dependencies(node, env, path):
+        # Every file included when the header was last processed (from the dependency file written
+        # alongside the generated file), so the file is regenerated when any of them change. On
+        # the first build there is no dependency file, but the file is generated anyway
+        if not str(node).endswith(".gen.cpp"):
+            return []
+        return [env.File(os.path.abspath(x)) for x in gdexport.header_dependencies(str(node))
+                if os.path.exists(x)]
+
+    def gdexport_jumbo(env,target,source):
+        gdexport.write_jumbo([str(x) for x in source], [str(x) for x in target])
 
     env.Append(BUILDERS={
         "GDExportEntryPoint" : Builder(action=gdexport_entry_point),
         "GDExportHeader" : Builder(action=gdexport_export_header,
-                                   suffix='.gen.cpp', src_suffix='.hpp', emitter=doc_emitter)
+                                   suffix='.gen.cpp', src_suffix='.hpp', emitter=doc_emitter,
+                                   target_scanner=Scanner(function=gdexport_scan_dependencies,
+                                                          name="GDExportDependencies")),
+        "GDExportJumbo" : Builder(action=gdexport_jumbo)
     })
 
     if destination:
@@ -129,9 +207,16 @@ def configure_generate(env,
             headers = env.GDExportHeader(dest/path.stem, source=x)
             sources.append(headers[0])
             docs += headers[1:]
-        if docs:
-            sources += env.GodotCPPDocData(dest/(name+".doc.cpp"), source=docs)
     else:
-        sources = [env.GDExportHeader(dest/pathlib.Path(str(x)).stem, source=x) for x in files]
-    sources += env.GDExportEntryPoint(dest/(name+'.lib.cpp'), source=files)
+        sources = [env.GDExportHeader(dest/pathlib.Path(str(x)).stem, source=x)[0] for x in files]
+    # The generated file for each header, whose manifests hold the registration plan
+    generated = list(sources)
+    if jumbo and jumbo > 0:
+        # The generated files are then only compiled as part of the jumbo files
+        sources = env.GDExportJumbo(gdexport.jumbo_outputs(name, files, jumbo, str(dest)), source=sources)
+    if documentation and (env["target"] in ["editor", "template_debug"]) and docs:
+        sources += env.GodotCPPDocData(dest/(name+".doc.cpp"), source=docs)
+    entry = env.GDExportEntryPoint(dest/(name+'.lib.cpp'), source=files)
+    env.Depends(entry, generated)
+    sources += entry
     return sources
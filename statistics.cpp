@@ -0,0 +1,162 @@
+// SPDX-FileCopyrightText: 2025 Gridshadows Gaming <https://www.gridshadows.co.uk>
+// SPDX-License-Identifier: Zlib
+
+#include "statistics.hpp"
+
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/Process.h"
+
+#include <atomic>
+#include <cstdint>
+
+namespace
+{
+    constexpr std::size_t PhaseCount = static_cast<std::size_t>(Phase::Count);
+
+    std::atomic<bool> enabled(false);
+    std::atomic<uint64_t> counts[PhaseCount];
+    std::atomic<int64_t> nanoseconds[PhaseCount];
+    Statistics::Clock::time_point started;
+
+    /**
+     * The peak bytes allocated by malloc (sampled as phases are recorded), and the peak bytes of
+     * documentation held in memory and the total bytes moved to temporary files (see
+     * ExtractDocVisitor)
+     */
+    std::atomic<std::size_t> peakHeap;
+    std::atomic<std::size_t> peakDocumentation;
+    std::atomic<std::size_t> spilledDocumentation;
+
+    void UpdatePeak(std::atomic<std::size_t>& peak, std::size_t value)
+    {
+        auto current = peak.load(std::memory_order_relaxed);
+        while((value > current) && !peak.compare_exchange_weak(current, value, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    /**
+     * The number of scopes entered (and not yet left) for each phase on the current thread
+     */
+    thread_local unsigned int depth[PhaseCount];
+}
+
+void Statistics::Start()
+{
+    for(std::size_t i = 0; i != PhaseCount; ++i)
+    {
+        counts[i].store(0, std::memory_order_relaxed);
+        nanoseconds[i].store(0, std::memory_order_relaxed);
+    }
+    peakHeap.store(0, std::memory_order_relaxed);
+    peakDocumentation.store(0, std::memory_order_relaxed);
+    spilledDocumentation.store(0, std::memory_order_relaxed);
+    started = Clock::now();
+    enabled.store(true, std::memory_order_relaxed);
+}
+
+void Statistics::Stop()
+{
+    enabled.store(false, std::memory_order_relaxed);
+}
+
+bool Statistics::Enabled()
+{
+    return enabled.load(std::memory_order_relaxed);
+}
+
+void Statistics::Record(Phase phase, Clock::duration duration)
+{
+    auto index = static_cast<std::size_t>(phase);
+    counts[index].fetch_add(1, std::memory_order_relaxed);
+    nanoseconds[index].fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count(),
+        std::memory_order_relaxed);
+    UpdatePeak(peakHeap, llvm::sys::Process::GetMallocUsage());
+}
+
+void Statistics::RecordDocumentationMemory(std::size_t buffered, std::size_t spilled)
+{
+    if(Enabled())
+    {
+        UpdatePeak(peakDocumentation, buffered);
+        spilledDocumentation.fetch_add(spilled, std::memory_order_relaxed);
+    }
+}
+
+void Statistics::Write(llvm::raw_ostream& os, llvm::StringRef header)
+{
+    UpdatePeak(peakHeap, llvm::sys::Process::GetMallocUsage());
+    llvm::json::OStream json(os, 2);
+    json.object([&]
+        {
+            json.attribute("version", 1);
+            json.attribute("header", header);
+            json.attribute("seconds", std::chrono::duration<double>(Clock::now() - started).count());
+            json.attributeObject("phases", [&]
+                {
+                    for(std::size_t i = 0; i != PhaseCount; ++i)
+                    {
+                        json.attributeObject(Name(static_cast<Phase>(i)), [&]
+                            {
+                                json.attribute("count", static_cast<int64_t>(counts[i].load(std::memory_order_relaxed)));
+                                json.attribute("seconds", nanoseconds[i].load(std::memory_order_relaxed) / 1e9);
+                            });
+                    }
+                });
+            json.attributeObject("memory", [&]
+                {
+                    json.attribute("peak_heap_bytes", static_cast<int64_t>(peakHeap.load(std::memory_order_relaxed)));
+                    json.attribute("peak_documentation_bytes",
+                        static_cast<int64_t>(peakDocumentation.load(std::memory_order_relaxed)));
+                    json.attribute("spilled_documentation_bytes",
+                        static_cast<int64_t>(spilledDocumentation.load(std::memory_order_relaxed)));
+                });
+        });
+    os << '\n';
+}
+
+llvm::StringRef Statistics::Name(Phase phase)
+{
+    switch(phase)
+    {
+    case Phase::Attributes:
+        return "attributes";
+    case Phase::Traversal:
+        return "traversal";
+    case Phase::Types:
+        return "types";
+    case Phase::Emission:
+        return "emission";
+    case Phase::Documentation:
+        return "documentation";
+    case Phase::Count:
+    default:
+        return "";
+    }
+}
+
+PhaseScope::PhaseScope(Phase p, llvm::StringRef name, llvm::StringRef detail)
+    : trace(name, detail)
+    , phase(p)
+    , recording(Statistics::Enabled())
+    , outermost(false)
+    , start()
+{
+    if(recording)
+    {
+        outermost = (depth[static_cast<std::size_t>(phase)]++ == 0);
+        if(outermost)
+        {
+            start = Statistics::Clock::now();
+        }
+    }
+}
+
+PhaseScope::~PhaseScope()
+{
+    if(recording)
+    {
+        --depth[static_cast<std::size_t>(phase)];
+        Statistics::Record(phase, (outermost) ? (Statistics::Clock::now() - start) : Statistics::Clock::duration::zero());
+    }
+}
@@ -0,0 +1,146 @@
+// SPDX-FileCopyrightText: 2025 Gridshadows Gaming <https://www.gridshadows.co.uk>
+// SPDX-License-Identifier: Zlib
+
+#ifndef GDEXPORT_STATISTICS_HPP
+#define GDEXPORT_STATISTICS_HPP
+
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/TimeProfiler.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <chrono>
+#include <cstddef>
+
+/**
+ * The phases of processing a header file for which statistics are recorded (see PhaseScope)
+ */
+enum class Phase : unsigned int
+{
+    /**
+     * Handling the godot attributes while parsing the header (see attributes.cpp)
+     */
+    Attributes,
+    /**
+     * Traversing the AST with the visitor (includes the other phases, except Attributes)
+     */
+    Traversal,
+    /**
+     * Resolving the godot types of C++ types (see GodotType::Parse)
+     */
+    Types,
+    /**
+     * Writing the generated code
+     */
+    Emission,
+    /**
+     * Parsing the documentation comments and writing the XML documentation
+     */
+    Documentation,
+    /**
+     * The number of phases
+     */
+    Count
+};
+
+/**
+ * The statistics (the number of times each phase was entered, the time spent in each phase, and
+ * the peak memory use) for processing a header file.
+ *
+ * The statistics are only recorded between calls to Start and Stop, as there is only one
+ * translation unit processed at a time (even by the batch driver). Recording is thread safe, so
+ * phases can be recorded from worker threads (e.g., writing the XML documentation), in which case
+ * the time for the phase is the sum of the time on each thread.
+ */
+class Statistics
+{
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    /**
+     * Clear the statistics, and start recording
+     */
+    static void Start();
+
+    /**
+     * Stop recording the statistics
+     */
+    static void Stop();
+
+    /**
+     * Gets whether statistics are being recorded
+     *
+     * @return true if statistics are being recorded
+     */
+    static bool Enabled();
+
+    /**
+     * Record that a phase was entered
+     *
+     * @param phase The phase
+     * @param duration The time spent in the phase (zero for nested phases, which are already
+     *                 included in the enclosing phase)
+     */
+    static void Record(Phase phase, Clock::duration duration);
+
+    /**
+     * Record the memory used by the rendered XML documentation (when streaming the documentation)
+     *
+     * @param buffered The number of bytes of documentation held in memory
+     * @param spilled The number of bytes of documentation moved to temporary files
+     */
+    static void RecordDocumentationMemory(std::size_t buffered, std::size_t spilled = 0);
+
+    /**
+     * Write the statistics as JSON, including the time since recording started (i.e., the time
+     * spent parsing and processing the header)
+     *
+     * @param os The stream to write to
+     * @param header The header file the statistics are for
+     */
+    static void Write(llvm::raw_ostream& os, llvm::StringRef header);
+
+    /**
+     * Gets the name of a phase, as written to the JSON statistics
+     *
+     * @param phase The phase
+     * @return The name of the phase
+     */
+    static llvm::StringRef Name(Phase phase);
+};
+
+/**
+ * Scope which records a phase in the Statistics (if enabled), and as a named scope for clang's
+ * `-ftime-trace` (if enabled), so the time spent by gdexport is shown alongside clang's phases.
+ *
+ * Nested scopes for the same phase (e.g., from recursive calls) are counted, but only the
+ * outermost scope is timed.
+ */
+class PhaseScope
+{
+public:
+    /**
+     * Enter the phase
+     *
+     * @param p The phase
+     * @param name The name of the scope in the time trace
+     * @param detail The detail (e.g., the name of the class) of the scope in the time trace
+     */
+    PhaseScope(Phase p, llvm::StringRef name, llvm::StringRef detail = {});
+
+    PhaseScope(const PhaseScope&) = delete;
+    PhaseScope& operator=(const PhaseScope&) = delete;
+
+    /**
+     * Leave the phase
+     */
+    ~PhaseScope();
+
+private:
+    llvm::TimeTraceScope trace;
+    Phase phase;
+    bool recording;
+    bool outermost;
+    Statistics::Clock::time_point start;
+};
+
+#endif // GDEXPORT_STATISTICS_HPP
@@ -2,9 +2,13 @@
 // SPDX-License-Identifier: Zlib
 
 #include "utilities.hpp"
+#include "statistics.hpp"
 
 #include "clang/AST/DeclCXX.h"
 #include "clang/AST/DeclTemplate.h"
+#include "llvm/Support/Error.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
 
 #include <unordered_map>
 
@@ -33,7 +37,26 @@ namespace clang
     const TemplateArgument* end(const TemplateArgumentList& list) { return list.data()+list.size(); }
 }
 
-std::string ParseString(Expr**& current, Expr** end, const std::string& defaultValue, bool& found)
+GodotAttribute ClassifyAttribute(StringRef annotation)
+{
+    if(!annotation.consume_front("godot::"))
+    {
+        return GodotAttribute::None;
+    }
+    // The hashes are distinct (or the case labels would not compile), so only one comparison is
+    // required to confirm the match
+    switch(AttributeHash(std::string_view(annotation.data(), annotation.size())))
+    {
+#define GODOT_FUNCTION_ATTRIBUTE(NAME, ENUM, REQ, OPT, NAME_PREFIX) \
+    case AttributeHash(#NAME): \
+        return (annotation == #NAME) ? GodotAttribute::ENUM : GodotAttribute::None;
+#include "attributes.def"
+    default:
+        return GodotAttribute::None;
+    }
+}
+
+StringRef ParseString(Expr**& current, Expr** end, const StringRef& defaultValue, bool& found)
 {
     found = false;
     StringLiteral* str = nullptr;
@@ -44,7 +67,7 @@ std::string ParseString(Expr**& current, Expr** end, const std::string& defaultV
     }
     found = str;
     return (str)
-        ? str->getString().str()
+        ? str->getString()
         : defaultValue;
 }
 
@@ -70,7 +93,7 @@ std::string ParseEnum(Expr* expr, const std::string& defaultValue, bool& parsed,
 }
 
 std::string ParseEnum(ASTContext& context, Expr**& current, Expr** end, const std::string& defaultValue,
-    const StringRef& argument, const std::string& propertyName, uint64_t maxValue)
+    const StringRef& argument, const StringRef& propertyName, uint64_t maxValue)
 {
     if(current != end)
     {
@@ -106,7 +129,7 @@ std::string ParseBitfield(Expr* current, const std::string& defaultValue, bool&
 }
 
 std::string ParseBitfield(ASTContext& context, Expr**& current, Expr** end, const std::string& defaultValue,
-    const StringRef& argument, const std::string& propertyName)
+    const StringRef& argument, const StringRef& propertyName)
 {
     if(current != end)
     {
@@ -123,8 +146,27 @@ std::string ParseBitfield(ASTContext& context, Expr**& current, Expr** end, cons
     return defaultValue;
 }
 
-GodotType& GodotType::Parse(const QualType& type, const std::string& variantHint, bool expandTemplate)
+/**
+ * Read the values of an enum from its declaration
+ *
+ * @param enumType The declaration of the enum
+ * @return The values of the enum
+ */
+static std::shared_ptr<const EnumValueMap> ReadEnumValues(const EnumDecl* enumType)
 {
+    auto values = std::make_shared<EnumValueMap>();
+    std::transform(enumType->enumerator_begin(), enumType->enumerator_end(),
+        std::inserter(*values, values->end()), [](const EnumConstantDecl* constant)
+            {
+                return std::make_pair(constant->getValue().getLimitedValue(),constant->getName().str());
+            });
+    return values;
+}
+
+GodotType& GodotType::Parse(const QualType& type, const std::string& variantHint, bool expandTemplate,
+    GodotTypeCache* cache)
+{
+    PhaseScope scope(Phase::Types, "GodotType::Parse");
     auto actualType = GetUnderlyingType(type);
     auto ptr = dyn_cast<PointerType>(actualType);
 
@@ -167,11 +209,7 @@ GodotType& GodotType::Parse(const QualType& type, const std::string& variantHint
             VariantType = "::godot::Variant::INT";
             TypeName = "int";
             EnumName = std::string{enumType->getName()};
-            std::transform(enumType->enumerator_begin(), enumType->enumerator_end(),
-                std::inserter(EnumValues, EnumValues.end()), [](const EnumConstantDecl* constant)
-                    {
-                        return std::make_pair(constant->getValue().getLimitedValue(),constant->getName().str());
-                    });
+            EnumValues = (cache) ? cache->EnumValues(enumType) : ReadEnumValues(enumType);
             return *this;
         }
     }
@@ -195,7 +233,7 @@ GodotType& GodotType::Parse(const QualType& type, const std::string& variantHint
                 {
                     Parse(arg.getAsType(),
                         (bitfield && variantHint.empty()) ?  "::godot::Variant::INT" : variantHint,
-                        expandTemplate);
+                        expandTemplate, cache);
                     if(bitfield)
                     {
                         IsBitfield = true;
@@ -235,8 +273,9 @@ GodotType& GodotType::Parse(const QualType& type, const std::string& variantHint
                 if(arg.getKind() == TemplateArgument::ArgKind::Type)
                 {
                     // We only want to parse the type, not worry about the Godot variant enum value
-                    GodotType type(arg.getAsType(), "::godot::Variant::NIL", false);
-                    TypeName += prefix + type.TypeName;
+                    TypeName += prefix + ((cache)
+                        ? cache->Get(arg.getAsType(), "::godot::Variant::NIL", false).TypeName
+                        : GodotType(arg.getAsType(), "::godot::Variant::NIL", false).TypeName);
                     prefix = ',';
                 }
                 else if(arg.getKind() == TemplateArgument::ArgKind::Null)
@@ -254,6 +293,30 @@ GodotType& GodotType::Parse(const QualType& type, const std::string& variantHint
     return *this;
 }
 
+const GodotType& GodotTypeCache::Get(const QualType& type, const std::string& variantHint, bool expandTemplate)
+{
+    auto key = std::make_tuple(type.getCanonicalType().getTypePtr(), variantHint, expandTemplate);
+    auto it = types.find(key);
+    if(it != types.end())
+    {
+        return it->second;
+    }
+    // Parse before inserting, as parsing may add the template arguments to the cache
+    GodotType result;
+    result.Parse(type, variantHint, expandTemplate, this);
+    return types.emplace(std::move(key), std::move(result)).first->second;
+}
+
+std::shared_ptr<const EnumValueMap> GodotTypeCache::EnumValues(const EnumDecl* declaration)
+{
+    auto& values = enums[declaration];
+    if(!values)
+    {
+        values = ReadEnumValues(declaration);
+    }
+    return values;
+}
+
 StringRef FindGodotTypeInInheritance(const CXXRecordDecl* cls)
 {
     std::unordered_map<StringRef, StringRef> g_godotTypes{
@@ -334,3 +397,88 @@ bool IsInGodotNamespace(const Decl* declaration)
 
     return ns->getName() == "godot";
 }
+
+std::error_code WriteFileIfChanged(StringRef path, StringRef content)
+{
+    // Compared directly, as the existing file must be read either way (and a hash of the content
+    // would have to be computed for both)
+    {
+        // Released before writing, as a mapped file cannot be replaced on Windows
+        auto existing = llvm::MemoryBuffer::getFile(path, false, false);
+        if(existing && ((*existing)->getBuffer() == content))
+        {
+            return std::error_code();
+        }
+    }
+    return llvm::errorToErrorCode(llvm::writeToOutput(path, [content](llvm::raw_ostream& os)
+        {
+            os << content;
+            return llvm::Error::success();
+        }));
+}
+
+std::error_code WriteFileIfChanged(StringRef path, llvm::function_ref<std::error_code(llvm::raw_ostream&)> write)
+{
+    int fd;
+    llvm::SmallString<128> temporary;
+    if(auto err = llvm::sys::fs::createUniqueFile(path + ".%%%%%%.tmp", fd, temporary))
+    {
+        return err;
+    }
+    std::error_code err;
+    {
+        llvm::raw_fd_ostream os(fd, true);
+        err = write(os);
+        os.close();
+        if(!err && os.has_error())
+        {
+            err = os.error();
+        }
+        os.clear_error();
+    }
+    bool unchanged = false;
+    if(!err)
+    {
+        // Mapped rather than read, where possible, so neither file is copied into memory. Released
+        // before removing or renaming the temporary file, as a mapped file cannot be removed or
+        // replaced on Windows
+        auto existing = llvm::MemoryBuffer::getFile(path, false, false);
+        auto written = llvm::MemoryBuffer::getFile(temporary, false, false);
+        if(!written)
+        {
+            err = written.getError();
+        }
+        else
+        {
+            unchanged = existing && ((*existing)->getBuffer() == (*written)->getBuffer());
+        }
+    }
+    if(unchanged)
+    {
+        llvm::sys::fs::remove(temporary);
+        return std::error_code();
+    }
+    if(!err)
+    {
+        err = llvm::sys::fs::rename(temporary, path);
+    }
+    if(err)
+    {
+        llvm::sys::fs::remove(temporary);
+    }
+    return err;
+}
+
+WriteIfChangedStream::~WriteIfChangedStream()
+{
+    if(diag.hasErrorOccurred())
+    {
+        return;
+    }
+    auto err = WriteFileIfChanged(path, str());
+    if(err)
+    {
+        diag.Report(diag.getCustomDiagID(DiagnosticsEngine::Error,
+            "unable to write output file '%0': %1")) << path << err.message();
+    }
+}
@@ -5,10 +5,21 @@
 #define GDEXPORT_UTILITIES_HPP
 
 #include "clang/AST/ASTContext.h"
+#include "clang/AST/Attr.h"
 #include "clang/AST/Expr.h"
 #include "clang/Basic/SourceLocation.h"
 #include "clang/Lex/Lexer.h"
 #include "clang/Basic/SourceManager.h"
+#include "llvm/ADT/STLFunctionalExtras.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
 
 using namespace clang;
 
@@ -33,24 +44,74 @@ namespace std
     };
 }
 
+/**
+ * The custom attributes in the godot namespace (see attributes.def), as identified from the
+ * annotation attached to a declaration by the attribute
+ */
+enum class GodotAttribute
+{
+    /**
+     * Not a godot attribute
+     */
+    None,
+#define GODOT_FUNCTION_ATTRIBUTE(NAME, ENUM, REQ, OPT, NAME_PREFIX) ENUM,
+#include "attributes.def"
+};
+
+/**
+ * Const expression to evaluate the (32-bit FNV-1a) hash of an attribute name, used to classify the
+ * annotations with a switch (see ClassifyAttribute)
+ *
+ * @param name The name of the attribute (without the `godot::` prefix)
+ * @return The hash of the name
+ */
+constexpr uint32_t AttributeHash(std::string_view name)
+{
+    uint32_t hash = 2166136261u;
+    for(char c : name)
+    {
+        hash = (hash ^ static_cast<unsigned char>(c)) * 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * Classify the annotation of an annotation attribute as one of the godot attributes
+ *
+ * @param annotation The annotation (e.g., `godot::class`)
+ * @return The godot attribute, or GodotAttribute::None if not a godot attribute
+ */
+GodotAttribute ClassifyAttribute(StringRef annotation);
+
+/**
+ * Classify an annotation attribute as one of the godot attributes
+ *
+ * @param attr The annotation attribute
+ * @return The godot attribute, or GodotAttribute::None if not a godot attribute
+ */
+inline GodotAttribute ClassifyAttribute(const AnnotateAttr* attr)
+{
+    return ClassifyAttribute(attr->getAnnotation());
+}
+
 /**
  * Gets the raw source from the source file for the specified expression in the AST
  *
  * @tparam T The type of the expression
  * @param context The current AST context to get the source from
  * @param expr The expression to get the source for
- * @return The source for the expression
+ * @return The source for the expression (referencing the source file buffer)
  */
 template<typename T>
-std::string GetRawSource(ASTContext& context, T* expr)
+StringRef GetRawSource(ASTContext& context, T* expr)
 {
     auto& sm = context.getSourceManager();
     SourceLocation begin(expr->getBeginLoc());
     SourceLocation e(expr->getEndLoc());
     SourceLocation end(Lexer::getLocForEndOfToken(e, 0, sm, context.getLangOpts()));
     return (end < begin)
-        ? ""
-        : std::string(sm.getCharacterData(begin), sm.getCharacterData(end) - sm.getCharacterData(begin));
+        ? StringRef()
+        : StringRef(sm.getCharacterData(begin), sm.getCharacterData(end) - sm.getCharacterData(begin));
 }
 
 /**
@@ -129,9 +190,9 @@ void GenerateError(ASTContext& context, const char(&msg)[N], Args... args)
  * @param end Pointer to one-past-end of the array
  * @param defaultValue The default value to return if no next item (or next item is not a string)
  * @param found true if the next item was a string literalt, false otherwise
- * @return The string literal, or defaultValue if no string literal
+ * @return The string literal (referencing the AST), or defaultValue if no string literal
  */
-std::string ParseString(Expr**& current, Expr** end, const std::string& defaultValue, bool& found);
+StringRef ParseString(Expr**& current, Expr** end, const StringRef& defaultValue, bool& found);
 
 /**
  * Parse an enum constant (or integer constant) from an expression.
@@ -158,7 +219,7 @@ std::string ParseEnum(Expr* expr, const std::string& defaultValue, bool& parsed,
  * @return The enum literal, or defaultValue if no enum literal
  */
 std::string ParseEnum(ASTContext& context, Expr**& current, Expr** end, const std::string& defaultValue,
-    const StringRef& argument, const std::string& propertyName, uint64_t maxValue = UINT64_MAX);
+    const StringRef& argument, const StringRef& propertyName, uint64_t maxValue = UINT64_MAX);
 
 /**
  * Parse an enum constant, integer constant, or bitwise OR of these from an expression.
@@ -185,7 +246,15 @@ std::string ParseBitfield(Expr* current, const std::string& defaultValue, bool&
  * @return The enum literal, or defaultValue if no enum literal
  */
 std::string ParseBitfield(ASTContext& context, Expr**& current, Expr** end, const std::string& defaultValue,
-    const StringRef& argument, const std::string& propertyName);
+    const StringRef& argument, const StringRef& propertyName);
+
+class GodotTypeCache;
+
+/**
+ * The values of an enum (value to name of the enum constant), shared between every GodotType for
+ * the enum
+ */
+typedef std::map<uint64_t, std::string> EnumValueMap;
 
 /**
  * Structure to gold information about a parsed type compatible with Godot: The Godot "Variant" name,
@@ -245,8 +314,10 @@ struct GodotType
      * @param variantHint Hint to the actual godot Variant type (don't need to deduce)
      * @param expandTemplate true to expand template parameters; false otherwise
      *                       (Godot only supports one level of template arguments)
+     * @param cache Optional cache to resolve template arguments and enum values from
      */
-    GodotType& Parse(const QualType& type, const std::string& variantHint = "", bool expandTemplate = true);
+    GodotType& Parse(const QualType& type, const std::string& variantHint = "", bool expandTemplate = true,
+        GodotTypeCache* cache = nullptr);
 
     /**
      * The Godot "Variant" name (i.e., a value from godot::Variant::Type) as a fully-qualified C++ name
@@ -266,9 +337,10 @@ struct GodotType
     std::string EnumName;
 
     /**
-     * If type is an enum, specifies the list of valid enum values (TypeName will be `int`)
+     * If type is an enum, specifies the list of valid enum values (TypeName will be `int`);
+     * otherwise null
      */
-    std::map<uint64_t, std::string> EnumValues;
+    std::shared_ptr<const EnumValueMap> EnumValues;
 
     /**
      * If an enum specifies this is a bitfield (EnumName non-empty)
@@ -276,6 +348,39 @@ struct GodotType
     bool IsBitfield;
 };
 
+/**
+ * Cache of the types resolved (see GodotType::Parse) for a translation unit, keyed on the
+ * canonical type, variant hint and whether to expand template arguments; so each type is only
+ * resolved once. The enum values are shared between every type for the same enum.
+ */
+class GodotTypeCache
+{
+public:
+    GodotTypeCache() : types(), enums() { }
+
+    /**
+     * Gets the resolved type for a qualified C++ type from the AST, resolving it if not already cached
+     *
+     * @param type The qualified C++ type from the clang AST
+     * @param variantHint Hint to the actual godot Variant type (don't need to deduce)
+     * @param expandTemplate true to expand template parameters; false otherwise
+     * @return The resolved type (valid until the cache is destroyed)
+     */
+    const GodotType& Get(const QualType& type, const std::string& variantHint = "", bool expandTemplate = true);
+
+    /**
+     * Gets the values of an enum, reading them from the declaration if not already cached
+     *
+     * @param declaration The declaration of the enum
+     * @return The values of the enum
+     */
+    std::shared_ptr<const EnumValueMap> EnumValues(const EnumDecl* declaration);
+
+private:
+    std::map<std::tuple<const Type*, std::string, bool>, GodotType> types;
+    std::unordered_map<const EnumDecl*, std::shared_ptr<const EnumValueMap>> enums;
+};
+
 /**
  * Attempts to deduce the Godot Variant type by recursing through the class hierarchy of the specified class
  *
@@ -308,4 +413,62 @@ inline const Type* GetUnderlyingType(const QualType& type)
     return type.getNonReferenceType().getTypePtr()->getUnqualifiedDesugaredType();
 }
 
+/**
+ * Write the content of a file, only if the content differs from the existing file (so the
+ * modification time of an unchanged file is preserved, and dependent files are not rebuilt). The
+ * file is written to a temporary file which is renamed once complete.
+ *
+ * @param path The file to write
+ * @param content The content of the file
+ * @return The error writing the file (or success)
+ */
+std::error_code WriteFileIfChanged(StringRef path, StringRef content);
+
+/**
+ * Write the content of a file, only if the content differs from the existing file, without
+ * holding the content in memory: the content is written to a temporary file alongside the file,
+ * which is compared with the existing file, and replaces it if different.
+ *
+ * @param path The file to write
+ * @param write Function writing the content of the file to the stream, returning an error to
+ *              leave the existing file unchanged
+ * @return The error writing the file (or success)
+ */
+std::error_code WriteFileIfChanged(StringRef path, llvm::function_ref<std::error_code(llvm::raw_ostream&)> write);
+
+/**
+ * Holds the buffer of a WriteIfChangedStream, so it is constructed before the stream
+ */
+struct WriteIfChangedBuffer
+{
+    llvm::SmallString<0> Buffer;
+};
+
+/**
+ * Output stream which buffers the content of a file in memory, and writes the file with
+ * WriteFileIfChanged when the stream is destroyed
+ */
+class WriteIfChangedStream : private WriteIfChangedBuffer, public llvm::raw_svector_ostream
+{
+public:
+    /**
+     * Create the stream
+     *
+     * @param file The file to write
+     * @param diagnostics The diagnostics to report an error writing the file to. The file is not
+     *                    written if an error has already been reported (as clang does for its
+     *                    output files)
+     */
+    WriteIfChangedStream(const std::string& file, DiagnosticsEngine& diagnostics)
+        : WriteIfChangedBuffer(), llvm::raw_svector_ostream(Buffer), path(file), diag(diagnostics)
+    {
+    }
+
+    ~WriteIfChangedStream() override;
+
+private:
+    std::string path;
+    DiagnosticsEngine& diag;
+};
+
 #endif // GDEXPORT_UTILITIES_HPP
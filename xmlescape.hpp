@@ -0,0 +1,104 @@
+// SPDX-FileCopyrightText: 2025 Gridshadows Gaming <https://www.gridshadows.co.uk>
+// SPDX-License-Identifier: Zlib
+
+#ifndef GDEXPORT_XMLESCAPE_HPP
+#define GDEXPORT_XMLESCAPE_HPP
+
+// The search for the characters to escape in the XML documentation (see EscapeXML in
+// extractdocvisitor.cpp). In a header of its own, so the escaping benchmark (escapebench.cpp) can
+// compare the vectorised and scalar searches without linking clang.
+
+#include "llvm/ADT/bit.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define GDEXPORT_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#define GDEXPORT_NEON
+#include <arm_neon.h>
+#endif
+
+/**
+ * Checks if the character must be escaped in XML
+ *
+ * @param c The character
+ * @return true if the character is one of `"'<>&`; false, otherwise
+ */
+constexpr bool IsXMLSpecial(char c)
+{
+    return (c == '"') || (c == '\'') || (c == '<') || (c == '>') || (c == '&');
+}
+
+/**
+ * Finds the first character which must be escaped in XML, one character at a time
+ *
+ * @param begin The start of the text to search
+ * @param end The end of the text to search
+ * @return Pointer to the first character to escape; or end if there is no such character
+ */
+inline const char* FindXMLSpecialScalar(const char* begin, const char* end)
+{
+    for(; begin != end; ++begin)
+    {
+        if(IsXMLSpecial(*begin))
+        {
+            return begin;
+        }
+    }
+    return end;
+}
+
+/**
+ * Finds the first character which must be escaped in XML
+ *
+ * Where available, scans 16 bytes at a time with SSE2 or NEON, falling back to a scalar scan for
+ * the remainder of the string (or the whole string, if neither is available).
+ *
+ * @param begin The start of the text to search
+ * @param end The end of the text to search
+ * @return Pointer to the first character to escape; or end if there is no such character
+ */
+inline const char* FindXMLSpecial(const char* begin, const char* end)
+{
+#if defined(GDEXPORT_SSE2)
+    const __m128i quot = _mm_set1_epi8('"');
+    const __m128i apos = _mm_set1_epi8('\'');
+    const __m128i lt = _mm_set1_epi8('<');
+    const __m128i gt = _mm_set1_epi8('>');
+    const __m128i amp = _mm_set1_epi8('&');
+    for(; end - begin >= 16; begin += 16)
+    {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+        __m128i found = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, quot), _mm_cmpeq_epi8(chunk, apos)),
+            _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, lt), _mm_cmpeq_epi8(chunk, gt)),
+                _mm_cmpeq_epi8(chunk, amp)));
+        int mask = _mm_movemask_epi8(found);
+        if(mask != 0)
+        {
+            return begin + llvm::countr_zero(static_cast<unsigned int>(mask));
+        }
+    }
+#elif defined(GDEXPORT_NEON)
+    const uint8x16_t quot = vdupq_n_u8('"');
+    const uint8x16_t apos = vdupq_n_u8('\'');
+    const uint8x16_t lt = vdupq_n_u8('<');
+    const uint8x16_t gt = vdupq_n_u8('>');
+    const uint8x16_t amp = vdupq_n_u8('&');
+    for(; end - begin >= 16; begin += 16)
+    {
+        uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8_t*>(begin));
+        uint8x16_t found = vorrq_u8(
+            vorrq_u8(vceqq_u8(chunk, quot), vceqq_u8(chunk, apos)),
+            vorrq_u8(vorrq_u8(vceqq_u8(chunk, lt), vceqq_u8(chunk, gt)), vceqq_u8(chunk, amp)));
+        if(vmaxvq_u8(found) != 0)
+        {
+            // Locate the character within the chunk with the scalar scan
+            break;
+        }
+    }
+#endif
+    return FindXMLSpecialScalar(begin, end);
+}
+
+#endif // GDEXPORT_XMLESCAPE_HPP